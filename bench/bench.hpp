@@ -0,0 +1,33 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+
+namespace yaza::bench {
+/// prevent the compiler from optimizing `value` out
+template <class T>
+inline void keep(const T& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/// run `fn` `repeat` times and print the best time per operation,
+/// assuming that `fn` performs `ops` operations
+template <class Fn>
+double measure(const char* name, size_t ops, Fn&& fn, int repeat = 5) {
+  double best = 0;
+  for (int i = 0; i < repeat; ++i) {
+    const auto begin = std::chrono::steady_clock::now();
+    fn();
+    const auto   end = std::chrono::steady_clock::now();
+    const double ns_per_op =
+        std::chrono::duration<double, std::nano>(end - begin).count() /
+        static_cast<double>(ops);
+    if (i == 0 || ns_per_op < best) {
+      best = ns_per_op;
+    }
+  }
+  std::printf("%-40s %10.2f ns/op\n", name, best);
+  return best;
+}
+}  // namespace yaza::bench
@@ -0,0 +1,155 @@
+// Compares ObbBatch::raycast with calling with_obb for each box, and checks
+// that both return the same nearest distance. with_surface is measured for
+// reference, since it is tested against the surface of each hit box
+
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <glm/ext/matrix_float4x4.hpp>
+#include <glm/common.hpp>
+#include <glm/ext/vector_float3.hpp>
+#include <glm/geometric.hpp>
+#include <optional>
+#include <random>
+#include <vector>
+
+#include "bench.hpp"
+#include "util/intersection.hpp"
+
+namespace yaza::bench {
+namespace {
+using util::intersection::ObbBatch;
+
+constexpr size_t kRays = 1 << 12;
+/// distances may differ by the order of floating point operations
+constexpr float kTolerance = 1e-4F;
+
+struct Scene {
+  std::vector<glm::mat4> model_mats;
+  std::vector<glm::vec3> half_sizes;
+  ObbBatch               batch;
+  std::vector<glm::vec3> origins;
+  std::vector<glm::vec3> directions;
+};
+
+/// boxes with random rotation around the origin, and rays toward them;
+/// every 4th box is axis-aligned like most surfaces in a scene
+Scene random_scene(size_t boxes, std::mt19937& rng) {
+  std::uniform_real_distribution<float> dist(-1.F, 1.F);
+  auto random_vec = [&dist, &rng] {
+    return glm::vec3(dist(rng), dist(rng), dist(rng));
+  };
+
+  Scene scene;
+  for (size_t i = 0; i < boxes; ++i) {
+    glm::vec3 x(1.F, 0.F, 0.F);
+    glm::vec3 y(0.F, 1.F, 0.F);
+    glm::vec3 z(0.F, 0.F, 1.F);
+    if (i % 4 != 0) {
+      x = glm::normalize(random_vec());
+      y = glm::normalize(glm::cross(x, random_vec()));
+      z = glm::cross(x, y);
+    }
+    glm::mat4 model_mat(1.F);
+    model_mat[0] = glm::vec4(x, 0.F);
+    model_mat[1] = glm::vec4(y, 0.F);
+    model_mat[2] = glm::vec4(z, 0.F);
+    model_mat[3] = glm::vec4(random_vec() * 4.F, 1.F);
+    auto half_size = glm::abs(random_vec()) * 0.5F + glm::vec3(0.1F);
+
+    scene.model_mats.push_back(model_mat);
+    scene.half_sizes.push_back(half_size);
+    scene.batch.push(model_mat, half_size);
+  }
+  for (size_t i = 0; i < kRays; ++i) {
+    auto origin = random_vec() * 8.F;
+    // aim around the center so that a part of the rays hit boxes
+    auto target = random_vec() * 2.F;
+    scene.origins.push_back(origin);
+    scene.directions.push_back(glm::normalize(target - origin));
+  }
+  return scene;
+}
+
+std::optional<float> nearest_with_obb(
+    const Scene& scene, const glm::vec3& origin, const glm::vec3& direction) {
+  std::optional<float> nearest;
+  for (size_t i = 0; i < scene.model_mats.size(); ++i) {
+    auto d = util::intersection::with_obb(
+        origin, direction, scene.half_sizes[i], scene.model_mats[i]);
+    if (d.has_value() && (!nearest.has_value() || *d < *nearest)) {
+      nearest = d;
+    }
+  }
+  return nearest;
+}
+
+/// return the number of rays whose result differs
+size_t count_mismatches(const Scene& scene, size_t* hits) {
+  size_t mismatches = 0;
+  for (size_t i = 0; i < kRays; ++i) {
+    auto expected =
+        nearest_with_obb(scene, scene.origins[i], scene.directions[i]);
+    auto actual = scene.batch.raycast(
+        scene.origins[i], scene.directions[i], 0, scene.batch.size());
+    if (expected.has_value() != actual.has_value() ||
+        (expected.has_value() && std::abs(*expected - *actual) > kTolerance)) {
+      ++mismatches;
+    }
+    *hits += expected.has_value() ? 1 : 0;
+  }
+  return mismatches;
+}
+
+/// return false if ObbBatch::raycast and with_obb disagree
+bool run(size_t boxes, std::mt19937& rng) {
+  auto   scene      = random_scene(boxes, rng);
+  size_t hits       = 0;
+  size_t mismatches = count_mismatches(scene, &hits);
+  std::printf("%zu boxes: %zu/%zu rays hit, %zu mismatches\n", boxes, hits,
+      kRays, mismatches);
+
+  // every result is per box so that the sizes are comparable
+  char name[64];
+  std::snprintf(name, sizeof(name), "ObbBatch::raycast (%zu boxes)", boxes);
+  measure(name, kRays * boxes, [&scene] {
+    for (size_t i = 0; i < kRays; ++i) {
+      keep(scene.batch.raycast(
+          scene.origins[i], scene.directions[i], 0, scene.batch.size()));
+    }
+  });
+  std::snprintf(name, sizeof(name), "with_obb (%zu boxes)", boxes);
+  measure(name, kRays * boxes, [&scene] {
+    for (size_t i = 0; i < kRays; ++i) {
+      keep(nearest_with_obb(scene, scene.origins[i], scene.directions[i]));
+    }
+  });
+  std::snprintf(name, sizeof(name), "with_surface (%zu boxes)", boxes);
+  measure(name, kRays * boxes, [&scene] {
+    for (size_t i = 0; i < kRays; ++i) {
+      for (size_t j = 0; j < scene.model_mats.size(); ++j) {
+        // the face of the box at -z, as a surface is placed in its box
+        const auto& m      = scene.model_mats[j];
+        const auto& h      = scene.half_sizes[j];
+        auto        center = glm::vec3(m[3]) - (glm::vec3(m[2]) * h.z);
+        auto        right  = glm::vec3(m[0]) * h.x;
+        auto        up     = glm::vec3(m[1]) * h.y;
+        keep(util::intersection::with_surface(scene.origins[i],
+            scene.directions[i], center - right - up, center + right - up,
+            center - right + up));
+      }
+    }
+  });
+  return mismatches == 0;
+}
+}  // namespace
+}  // namespace yaza::bench
+
+int main() {
+  std::mt19937 rng(1);  // NOLINT
+  bool         ok = true;
+  for (size_t boxes : {8U, 64U, 512U}) {
+    ok = yaza::bench::run(boxes, rng) && ok;
+  }
+  return ok ? 0 : 1;
+}
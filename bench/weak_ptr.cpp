@@ -0,0 +1,140 @@
+// Compares UniPtr/WeakPtr backed by generational slot tables with the
+// previous implementation backed by std::shared_ptr/std::weak_ptr
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "bench.hpp"
+#include "util/weakable_unique_ptr.hpp"
+
+namespace yaza::bench {
+namespace {
+constexpr size_t kObjects    = 1 << 16;
+constexpr int    kLockPasses = 16;
+
+struct Object {
+  explicit Object(uint64_t value) : value(value) {
+  }
+  uint64_t value;
+};
+
+/// UniPtr/WeakPtr before they were backed by slot tables
+namespace shared {
+template <class T>
+class WeakPtr {
+ public:
+  WeakPtr() = default;
+  explicit WeakPtr(const std::shared_ptr<T>& shared) : ptr_(shared) {
+  }
+  T* lock() const {
+    if (auto p = this->ptr_.lock()) {
+      return p.get();
+    }
+    return nullptr;
+  }
+
+ private:
+  std::weak_ptr<T> ptr_;
+};
+template <class T>
+class UniPtr {
+ public:
+  template <class... Args>
+  explicit UniPtr(Args&&... args)
+      : ptr_(std::make_shared<T>(std::forward<Args>(args)...)) {
+  }
+  WeakPtr<T> weak() const {
+    return WeakPtr<T>(this->ptr_);
+  }
+
+ private:
+  std::shared_ptr<T> ptr_;
+};
+}  // namespace shared
+
+/// visit objects in a random order so that the access pattern is similar to
+/// looking up handles held by unrelated objects
+std::vector<size_t> shuffled_indices() {
+  std::vector<size_t> indices(kObjects);
+  std::iota(indices.begin(), indices.end(), 0);
+  std::shuffle(indices.begin(), indices.end(), std::mt19937(1));  // NOLINT
+  return indices;
+}
+
+template <template <class> class Uni, template <class> class Weak>
+void run(const char* label) {
+  char name[64];
+  auto indices = shuffled_indices();
+
+  std::snprintf(name, sizeof(name), "%s: create and destroy", label);
+  measure(name, kObjects, [] {
+    std::vector<Uni<Object>> owners;
+    owners.reserve(kObjects);
+    for (size_t i = 0; i < kObjects; ++i) {
+      owners.emplace_back(i);
+    }
+    keep(owners.data());
+  });
+
+  std::vector<Uni<Object>> owners;
+  owners.reserve(kObjects);
+  for (size_t i = 0; i < kObjects; ++i) {
+    owners.emplace_back(i);
+  }
+  std::vector<Weak<Object>> weaks;
+  weaks.reserve(kObjects);
+  for (auto& owner : owners) {
+    weaks.push_back(owner.weak());
+  }
+
+  std::snprintf(name, sizeof(name), "%s: copy WeakPtr", label);
+  measure(name, kObjects, [&weaks] {
+    std::vector<Weak<Object>> copies(weaks);
+    keep(copies.data());
+  });
+
+  std::snprintf(name, sizeof(name), "%s: lock", label);
+  measure(name, kObjects * kLockPasses, [&weaks, &indices] {
+    uint64_t sum = 0;
+    for (int pass = 0; pass < kLockPasses; ++pass) {
+      for (size_t index : indices) {
+        if (auto* object = weaks[index].lock()) {
+          sum += object->value;
+        }
+      }
+    }
+    keep(sum);
+  });
+
+  // destroy every other owner so that the branch cannot be predicted
+  for (size_t i = 0; i < kObjects; i += 2) {
+    owners[i] = Uni<Object>(0);
+  }
+  std::snprintf(name, sizeof(name), "%s: lock (half expired)", label);
+  measure(name, kObjects * kLockPasses, [&weaks, &indices] {
+    uint64_t sum = 0;
+    for (int pass = 0; pass < kLockPasses; ++pass) {
+      for (size_t index : indices) {
+        if (auto* object = weaks[index].lock()) {
+          sum += object->value;
+        }
+      }
+    }
+    keep(sum);
+  });
+}
+}  // namespace
+}  // namespace yaza::bench
+
+int main() {
+  using namespace yaza;  // NOLINT(google-build-using-namespace)
+  bench::run<util::UniPtr, util::WeakPtr>("slot table");
+  bench::run<bench::shared::UniPtr, bench::shared::WeakPtr>("shared_ptr");
+  return 0;
+}
@@ -2,12 +2,20 @@
 
 #include <wayland-server.h>
 
+#include <cstdint>
 #include <glm/ext/vector_float3.hpp>
 #include <optional>
 
+#include "common.hpp"
+#include "util/aabb.hpp"
 #include "util/box.hpp"
 
 namespace yaza::input {
+class PickingTree;
+
+/// index of a pointing ray; the ray 0 always exists
+using RayId = uint32_t;
+
 // FIXME: are there any better data structures?
 struct IntersectInfo {
   // in; for BoundedApp
@@ -20,14 +28,11 @@ struct IntersectInfo {
 
 class BoundedObject {
  public:
+  DISABLE_MOVE_AND_COPY(BoundedObject);
   explicit BoundedObject(util::Box box) : geom_(box) {
   }
-  BoundedObject()                                = default;
-  BoundedObject(const BoundedObject&)            = default;
-  BoundedObject(BoundedObject&&)                 = default;
-  BoundedObject& operator=(const BoundedObject&) = default;
-  BoundedObject& operator=(BoundedObject&&)      = default;
-  virtual ~BoundedObject()                       = default;
+  BoundedObject() = default;
+  virtual ~BoundedObject();
   bool operator==(const BoundedObject& other) const {
     return this->resource() == other.resource();
   }
@@ -35,23 +40,33 @@ class BoundedObject {
     return !(*this == other);
   }
 
-  virtual void enter(IntersectInfo& intersect_info)                   = 0;
-  virtual void leave()                                                = 0;
-  virtual void motion(IntersectInfo& intersect_info)                  = 0;
-  virtual void button(uint32_t button, wl_pointer_button_state state) = 0;
-  virtual void axis(float amount)                                     = 0;
-  virtual void frame()                                                = 0;
+  virtual void enter(RayId ray, IntersectInfo& intersect_info)  = 0;
+  virtual void leave(RayId ray)                                 = 0;
+  virtual void motion(RayId ray, IntersectInfo& intersect_info) = 0;
+  virtual void button(
+      RayId ray, uint32_t button, wl_pointer_button_state state) = 0;
+  virtual void axis(RayId ray, float amount)                     = 0;
+  virtual void frame(RayId ray)                                  = 0;
 
   const util::Box& geometry() {
     return this->geom_;
   }
   virtual std::optional<IntersectInfo> check_intersection(
       const glm::vec3& origin, const glm::vec3& direction)              = 0;
+  /// world space bounds of everything `check_intersection` can hit
+  [[nodiscard]] virtual util::Aabb   world_bounds()                     = 0;
   virtual void                       move(float polar, float azimuthal) = 0;
   [[nodiscard]] virtual wl_resource* resource() const                   = 0;
   [[nodiscard]] virtual wl_client*   client() const                     = 0;
 
  protected:
   util::Box geom_;  // NOLINT
+  /// should be called whenever `world_bounds()` may have changed
+  void      bounds_changed();
+
+ private:
+  friend class PickingTree;
+  PickingTree* picking_tree_ = nullptr;
+  int32_t      picking_leaf_ = -1;
 };
 }  // namespace yaza::input
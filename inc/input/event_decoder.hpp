@@ -0,0 +1,96 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "common.hpp"
+
+namespace yaza::input {
+enum class EventType : uint32_t {  // NOLINT
+  MOUSE_MOVE = 1,
+  MOUSE_DOWN,
+  MOUSE_UP,
+  MOUSE_WHEEL,
+  BATCH,       // followed by `data.count` BatchedEvent
+  SELECT_RAY,  // following Events of the stream act on `data.ray`
+  PING,        // sent back to the sender after the preceding Events are handled
+};
+
+union EventData {
+  float    movement[2];  // MOUSE_MOVE
+  uint32_t button;       // MOUSE_{DOWN, UP} (reserved)
+  float    wheel_amount;
+  uint32_t count;  // BATCH
+  uint32_t ray;    // SELECT_RAY
+  uint32_t token;  // PING; chosen by the sender
+};
+
+struct Event {
+  uint32_t  magic;
+  EventType type;
+  EventData data;
+};
+
+/// an Event sent in a BATCH, which has no magic
+struct BatchedEvent {
+  EventType type;
+  EventData data;
+};
+
+/// "yaza" in the byte order of the stream
+constexpr uint32_t kEventMagic = ('y' << 24) | ('a' << 16) | ('z' << 8) | 'a';
+constexpr uint32_t kMaxBatchedEvents = 4096;
+/// rays selectable by SELECT_RAY
+constexpr uint32_t kMaxRays = 8;
+
+/// Reassembles Events from a byte stream of one client, which may split
+/// an Event across reads or put several Events in one read
+class EventDecoder {
+ public:
+  DISABLE_MOVE_AND_COPY(EventDecoder);
+  EventDecoder()  = default;
+  ~EventDecoder() = default;
+
+  /// free space to receive into; empty only if a single Event does not fit,
+  /// which never happens
+  std::span<uint8_t> writable();
+  /// `size` bytes are written into `writable()`
+  void commit(size_t size) {
+    this->tail_ += size;
+  }
+  /// return false if no complete Event is left. SELECT_RAY is consumed
+  /// here and reported by `ray()`
+  bool next(Event& event);
+  /// the ray the last Event returned by `next` acts on
+  [[nodiscard]] uint32_t ray() const {
+    return this->ray_;
+  }
+  /// drop everything received, for a decoder reused for each datagram
+  void reset() {
+    this->head_            = 0;
+    this->tail_            = 0;
+    this->batch_remaining_ = 0;
+    this->resyncing_       = false;
+    this->ray_             = 0;
+  }
+
+ private:
+  static constexpr size_t kBufferSize = 4096;
+
+  std::array<uint8_t, kBufferSize> buffer_{};
+  size_t                           head_            = 0;
+  size_t                           tail_            = 0;
+  uint32_t                         batch_remaining_ = 0;
+  bool                             resyncing_       = false;
+  uint32_t                         ray_             = 0;
+
+  /// return false if `event` is consumed by the decoder
+  bool accept(const Event& event);
+
+  [[nodiscard]] size_t readable() const {
+    return this->tail_ - this->head_;
+  }
+};
+}  // namespace yaza::input
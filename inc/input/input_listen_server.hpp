@@ -1,35 +1,53 @@
 #pragma once
 
+#include <wayland-server-core.h>
+
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
+#include <deque>
+#include <string>
 #include <thread>
+#include <unordered_map>
 
 #include "common.hpp"
+#include "input/event_decoder.hpp"
+#include "util/spsc_queue.hpp"
 
 namespace yaza::input {
 class ServerSeat;
 constexpr uint16_t kServerPort = 22202;
 
-enum class EventType : uint32_t {  // NOLINT
-  MOUSE_MOVE = 1,
-  MOUSE_DOWN,
-  MOUSE_UP,
-  MOUSE_WHEEL,
+/// selected by YAZA_INPUT_TRANSPORT=tcp|udp|unix at startup
+enum class Transport : uint8_t {
+  TCP,
+  /// datagrams start with a uint32_t sequence number followed by Events;
+  /// a datagram older than the latest one is dropped as a whole, so that
+  /// buttons are never handled out of order
+  UDP,
+  /// SOCK_SEQPACKET at YAZA_INPUT_SOCKET or $XDG_RUNTIME_DIR/yaza-input,
+  /// for input bridges on the same host
+  UNIX,
 };
 
-struct Event {
-  uint32_t  magic;
-  EventType type;
-  union {
-    float    movement[2];  // MOUSE_MOVE
-    uint32_t button;       // MOUSE_{DOWN, UP} (reserved)
-    float    wheel_amount;
-  } data;
-};
+constexpr float  kMouseMovementDivider = 1500.F;
+constexpr float  kMouseWheelDivider    = 100'000.F;
+constexpr size_t kEventQueueCapacity   = 1024;
 
-constexpr float kMouseMovementDivider = 1500.F;
-constexpr float kMouseWheelDivider    = 100'000.F;
+/// an Event with the ray selected by SELECT_RAY in its stream
+struct RayEvent {
+  uint32_t ray;
+  Event    event;
+};
 
 // owned by Seat
+/// Accepts input clients and receives their events in a dedicated thread
+/// which sleeps in epoll_wait while there is nothing to read.
+/// Received events are passed to the wayland event loop through a queue,
+/// so ServerSeat is only touched by the main thread.
+/// While the queue is full, the thread stops reading sockets until the main
+/// thread drains it, so that no event is dropped.
+/// PING is sent back by this thread once the main thread has handled it
 class InputListenServer {
  public:
   DISABLE_MOVE_AND_COPY(InputListenServer);
@@ -37,10 +55,64 @@ class InputListenServer {
   ~InputListenServer();
 
  private:
-  void handle_events(int client) const;
+  void accept_clients();
+  void receive_datagrams();
+  /// queue every complete Event of `decoder` received from `origin`
+  void queue_decoded(EventDecoder& decoder, uint64_t origin);
+  /// push `item`, waiting for the main thread while the queue is full;
+  /// return false if the thread is being stopped
+  bool push_event(const RayEvent& item);
+  /// read every available event of `client`;
+  /// return false if the connection should be closed
+  bool handle_events(int client);
+  void disconnect(int client);
+  /// send back PINGs handled by the main thread
+  void send_pongs();
+  void close_fds();
+  /// wake the wayland event loop if events were queued since the last call
+  void notify_events();
+  /// called by the wayland event loop
+  static int dispatch_events(int fd, uint32_t mask, void* data);
 
+  Transport   transport_;
+  std::string unix_path_;  // only for UNIX
   std::thread thread_;
-  int         socket_              = -1;
-  bool        terminate_requested_ = false;
+  int         socket_   = -1;
+  int         epoll_fd_ = -1;
+  int         wake_fd_  = -1;  // eventfd to stop the thread
+  struct Client {
+    std::string  address;
+    EventDecoder decoder;
+  };
+  /// connected clients keyed by their socket
+  std::unordered_map<int, Client> clients_;
+  /// the latest sequence number of each UDP sender keyed by address and port
+  std::unordered_map<uint64_t, uint32_t> sequences_;
+  EventDecoder                           datagram_decoder_;
+  uint64_t                               stale_datagrams_ = 0;
+
+  /// the socket of a stream client, or the address key of a UDP sender
+  struct Ping {
+    uint64_t origin;
+    uint32_t token;
+  };
+  /// PINGs queued but not sent back yet, in the order of the queue
+  std::deque<Ping> pings_;
+  /// eventfd written by the main thread when it handled PINGs
+  int                   pong_fd_       = -1;
+  std::atomic<uint32_t> handled_pings_ = 0;
+
+  util::SpscQueue<RayEvent, kEventQueueCapacity> queue_;
+  int              notify_fd_     = -1;  // eventfd polled by the event loop
+  wl_event_source* notify_source_ = nullptr;
+  /// eventfd written by the main thread when it drained the queue
+  /// while the input thread was waiting for space
+  int               space_fd_         = -1;
+  std::atomic<bool> producer_waiting_ = false;
+
+  // only touched by the input thread
+  bool     has_new_events_ = false;
+  bool     stopping_       = false;
+  uint64_t full_waits_     = 0;
 };
 }  // namespace yaza::input
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <glm/ext/vector_float3.hpp>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "common.hpp"
+#include "util/aabb.hpp"
+#include "util/weakable_unique_ptr.hpp"
+
+namespace yaza::input {
+class BoundedObject;
+
+/// Dynamic bounding volume hierarchy over the world bounds of every
+/// surface and bounded app, used to pick only objects whose bounds are hit.
+/// A leaf is refitted by BoundedObject::bounds_changed() and removed by the
+/// destructor of BoundedObject
+class PickingTree {
+ public:
+  DISABLE_MOVE_AND_COPY(PickingTree);
+  PickingTree()  = default;
+  ~PickingTree() = default;
+
+  struct Ray {
+    glm::vec3 origin;
+    glm::vec3 direction;
+  };
+  /// rays resolved by one `raycast`, which tracks them in a bit mask
+  static constexpr size_t kMaxRaysPerCast = 32;
+  using RayTest = std::function<std::optional<float>(
+      size_t ray, util::WeakPtr<BoundedObject>&)>;
+
+  void insert(util::WeakPtr<BoundedObject> obj);
+  /// walk the tree once for all `rays` and call `test` with the index of a
+  /// ray for every object whose bounds the ray enters before the nearest
+  /// distance returned by `test` for the ray so far
+  void raycast(std::span<const Ray> rays, const RayTest& test);
+
+ private:
+  friend class BoundedObject;
+  struct Node {
+    util::Aabb                   bounds;
+    int32_t                      parent = -1;
+    int32_t                      left   = -1;  // -1 for leaves
+    int32_t                      right  = -1;
+    util::WeakPtr<BoundedObject> obj;  // only for leaves
+  };
+  std::vector<Node>    nodes_;
+  std::vector<int32_t> free_nodes_;
+  int32_t              root_ = -1;
+  /// nodes with the rays still entering them, reused by raycast
+  std::vector<std::pair<int32_t, uint32_t>> stack_;
+
+  void    update(int32_t leaf, const util::Aabb& bounds);
+  void    remove(int32_t leaf);
+  int32_t allocate();
+  void    release(int32_t node);
+  void    attach(int32_t leaf);
+  void    detach(int32_t leaf);
+  /// recompute bounds from `node` up to the root
+  void    refit(int32_t node);
+};
+}  // namespace yaza::input
@@ -1,11 +1,17 @@
 #pragma once
 
+#include <wayland-server-core.h>
+
+#include <cstdint>
 #include <glm/ext/quaternion_float.hpp>
+#include <glm/ext/vector_float2.hpp>
 #include <glm/ext/vector_float3.hpp>
 #include <memory>
 #include <numbers>
+#include <optional>
 
 #include "common.hpp"
+#include "input/ray_predictor.hpp"
 #include "remote/session.hpp"
 #include "renderer.hpp"
 #include "util/signal.hpp"
@@ -15,17 +21,31 @@ class RayCaster {
  public:
   DISABLE_MOVE_AND_COPY(RayCaster);
   RayCaster();
-  ~RayCaster() = default;
+  ~RayCaster();
 
   constexpr static glm::vec3 kOrigin = glm::vec3(0.F, 0.849F, -0.001F);
+  /// the measured pose, for hit-testing
   [[nodiscard]] glm::vec3    direction() const;
   [[nodiscard]] glm::quat    rot() const;
+  /// the pose shown to the user; extrapolated to the next session frame if
+  /// YAZA_PREDICT_RAY=1, otherwise the same as the measured one
+  [[nodiscard]] glm::vec3    shown_direction() const;
+  [[nodiscard]] glm::quat    shown_rot() const {
+    return this->shown_rot_;
+  }
 
   /// return actually changed polar amount
   float move_rel(float polar, float azimuthal);
   /// length will be reset if nullopt is passed
   void  set_length(std::optional<float> len);
 
+  /// the shown pose is changed without `move_rel`, since the prediction
+  /// went back to the measured pose when the ray stopped
+  void listen_prediction_settled(util::Listener<std::nullptr_t*>& listener);
+  /// mean angle (degrees) between the shown and the measured pose at frame
+  /// deadlines
+  [[nodiscard]] float prediction_error() const;
+
  private:
   constexpr static glm::vec3 kBaseDirection = glm::vec3(0.F, 0.F, 1.F);
   constexpr static float     kDefaultRayLen = 3.4F;
@@ -34,11 +54,38 @@ class RayCaster {
   float     polar_     = std::numbers::pi / 2.F;  // [0, pi]
   float     azimuthal_ = std::numbers::pi;        // x-z plane, [0, 2pi]
   glm::quat rot_;
+  glm::quat shown_rot_;
 
   std::unique_ptr<Renderer> ray_renderer_;
   void                      init_ray_renderer();
   void                      update_ray_rot();
+  void                      show(const glm::vec2& angles);
+
+  /// only if the prediction is enabled
+  std::optional<RayPredictor> predictor_;
+  wl_event_source*            deadline_timer_ = nullptr;
+  struct Prediction {
+    RayPredictor::Clock::time_point deadline;
+    glm::vec2                       predicted;
+    glm::vec2                       measured;  // when predicted
+  };
+  std::optional<Prediction> pending_prediction_;
+  void                      predict();
+  /// compare the pending prediction with the pose at its deadline
+  void       score_prediction(RayPredictor::Clock::time_point now);
+  static int on_deadline(void* data);
+
+  struct {
+    uint64_t frames          = 0;
+    double   predicted_error = 0.;  // sum of degrees
+    double   measured_error  = 0.;  // sum of degrees without prediction
+    float    max             = 0.F;
+  } prediction_stats_;
+  void log_prediction_stats();
 
+  struct {
+    util::Signal<std::nullptr_t*> prediction_settled;
+  } events_;
   util::Listener<remote::Session*> session_established_listener_;
   util::Listener<std::nullptr_t*>  session_disconnected_listener_;
 };
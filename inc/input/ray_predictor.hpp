@@ -0,0 +1,59 @@
+#pragma once
+
+#include <chrono>
+#include <glm/ext/vector_float2.hpp>
+#include <optional>
+
+namespace yaza::input {
+/// One Euro filter: a low-pass filter whose cutoff rises with the speed of
+/// the signal, so that slow changes are smoothed and fast ones do not lag
+class OneEuroFilter {
+ public:
+  /// @param min_cutoff cutoff frequency (Hz) while the signal is steady
+  /// @param beta       cutoff added per unit/s of the signal's change
+  /// @param d_cutoff   cutoff frequency (Hz) for the change itself
+  OneEuroFilter(float min_cutoff, float beta, float d_cutoff)
+      : min_cutoff_(min_cutoff), beta_(beta), d_cutoff_(d_cutoff) {
+  }
+
+  float filter(float value, float dt_sec);
+  void  reset() {
+    this->prev_.reset();
+  }
+
+ private:
+  float min_cutoff_;
+  float beta_;
+  float d_cutoff_;
+
+  std::optional<float> prev_;
+  float                prev_change_ = 0.F;
+};
+
+/// Extrapolates (polar, azimuthal) of a ray with its velocity smoothed by
+/// OneEuroFilter. A ray at rest has no velocity, so it is never shifted
+class RayPredictor {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  /// feed the measured angles
+  void      update(const glm::vec2& angles, Clock::time_point now);
+  /// the angles expected at `deadline`
+  glm::vec2 predict(Clock::time_point deadline) const;
+  /// true if no angles were fed for long enough to consider the ray at rest
+  [[nodiscard]] bool at_rest(Clock::time_point now) const;
+  void               reset();
+
+ private:
+  OneEuroFilter polar_velocity_{1.5F, 0.05F, 1.F};
+  OneEuroFilter azimuthal_velocity_{1.5F, 0.05F, 1.F};
+  glm::vec2     velocity_ = glm::vec2(0.F);  // rad/s
+
+  /// the latest angles
+  glm::vec2         angles_ = glm::vec2(0.F);
+  Clock::time_point time_;
+  /// the angles the velocity was last computed from
+  std::optional<glm::vec2> sample_;
+  Clock::time_point        sample_time_;
+};
+}  // namespace yaza::input
@@ -5,15 +5,21 @@
 #include <wayland-server.h>
 #include <wayland-util.h>
 
+#include <array>
+#include <cstddef>
 #include <cstdint>
 #include <glm/ext/matrix_float4x4.hpp>
 #include <glm/ext/vector_float3.hpp>
+#include <memory>
+#include <optional>
 #include <unordered_map>
 
 #include "common.hpp"
 #include "input/bounded_object.hpp"
+#include "input/event_decoder.hpp"
 #include "input/input_listen_server.hpp"
 #include "input/ray_caster.hpp"
+#include "util/signal.hpp"
 #include "util/weakable_unique_ptr.hpp"
 #include "wayland/data_device/data_device.hpp"
 #include "wayland/seat.hpp"
@@ -27,7 +33,7 @@ enum class FocusedObjState : uint8_t {
 class ServerSeat {
  public:
   DISABLE_MOVE_AND_COPY(ServerSeat);
-  ServerSeat()  = default;
+  ServerSeat();
   ~ServerSeat() = default;
 
   std::unordered_map<wl_client*, wayland::seat::ClientSeat*> client_seats;
@@ -35,33 +41,56 @@ class ServerSeat {
   bool                              is_focused_client(wl_client* client);
   wayland::data_device::DataDevice* current_selection = nullptr;
 
-  void set_surface_as_cursor(
-      wl_resource* surface_resource, int32_t hotspot_x, int32_t hotspot_y);
+  /// set the cursor of the ray driving wl_pointer of `client`
+  void set_surface_as_cursor(wl_client* client, wl_resource* surface_resource,
+      int32_t hotspot_x, int32_t hotspot_y);
   void set_keyboard_focused_surface(util::WeakPtr<input::BoundedObject> obj);
 
-  void handle_mouse_button(uint32_t button, wl_pointer_button_state state);
-  void handle_mouse_wheel(float amount);
+  void handle_mouse_button(
+      RayId ray, uint32_t button, wl_pointer_button_state state);
+  void handle_mouse_wheel(RayId ray, float amount);
   void request_start_move(wl_client* client);
-  void move_rel_pointing(float polar, float azimuthal);
+  /// the ray is picked and its cursor is moved by the next `pick_rays`
+  void move_rel_pointing(RayId ray, float polar, float azimuthal);
+  /// resolve every ray moved since the last call in one pass over the
+  /// picking tree
+  void pick_rays();
 
  private:
-  void check_intersection();
+  /// focus, cursor and button state of one ray
+  struct Pointer {
+    RayCaster                    ray;
+    FocusedObjState              obj_state = FocusedObjState::DEFAULT;
+    util::WeakPtr<BoundedObject> focused_obj;
+    /// kept to release wl_pointer of the client even if `focused_obj` is
+    /// destroyed without leaving
+    wl_client*                   focused_client = nullptr;
+    bool                         needs_picking  = false;
 
-  FocusedObjState                     obj_state_ = FocusedObjState::DEFAULT;
-  util::WeakPtr<input::BoundedObject> focused_obj_;
-  /// return true if `focused_obj_` is changed
-  bool set_focused_obj(util::WeakPtr<input::BoundedObject> obj);
+    util::WeakPtr<BoundedObject> cursor;
+    glm::vec3 hotspot;  // OpenGL scale (divided by kPixelPerMeter)
+    float     cursor_distance = 0.F;
+    /// the cursor follows the shown pose of `ray`
+    util::Listener<std::nullptr_t*> prediction_settled_listener;
+  };
+  /// created when the ray is first used
+  std::array<std::unique_ptr<Pointer>, kMaxRays> pointers_;
+  /// return nullptr if `ray` is out of range
+  Pointer* pointer(RayId ray);
+
+  void resolve(RayId ray, util::WeakPtr<BoundedObject>& nearest_obj,
+      std::optional<IntersectInfo>& nearest_obj_info);
+  /// return true if `focused_obj` of `ray` is changed
+  bool set_focused_obj(RayId ray, util::WeakPtr<input::BoundedObject> obj);
 
   util::WeakPtr<input::BoundedObject> keyboard_focused_surface_;
   void                                try_leave_keyboard();
 
-  util::WeakPtr<input::BoundedObject> cursor_;
-  glm::vec3 hotspot_;  // OpenGL scale (divided by kPixelPerMeter)
-  float     cursor_distance_;
-  void      move_cursor();
+  void set_cursor(RayId ray, wl_resource* surface_resource, int32_t hotspot_x,
+      int32_t hotspot_y);
+  void move_cursor(RayId ray);
 
   InputListenServer input_listen_server_;
-  RayCaster         ray_;
 };
 
 }  // namespace yaza::input
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+#include "common.hpp"
+#include "util/data_pool.hpp"
+
+namespace yaza::remote {
+/// Keeps track of payloads (buffer, texture and shader data) transferred to
+/// the current session.
+/// Payloads are remembered by their digest to count uploads of bytes which
+/// another object has already sent, only if YAZA_CONTENT_STATS=1; the number
+/// of remembered payloads is bounded, and the least recently uploaded one is
+/// forgotten first
+class ContentStore {
+ public:
+  DISABLE_MOVE_AND_COPY(ContentStore);
+  ContentStore()  = default;
+  ~ContentStore() = default;
+
+  /// record that `data` is transferred to the remote; `data` is hashed only
+  /// if duplicates are tracked
+  void record_upload(util::DataPool& data);
+  /// record that a payload whose digest is known is transferred
+  void record_upload(uint64_t digest, size_t size);
+  /// record that a re-commit of identical bytes did not cause a transfer
+  void record_skip(size_t size);
+  /// print the statistics and forget all payloads of the session
+  void reset();
+
+ private:
+  void count_upload(size_t size);
+
+  /// digests, the most recently uploaded first
+  std::list<uint64_t> lru_;
+  /// digest -> size and the position in `lru_`
+  std::unordered_map<uint64_t, std::pair<size_t, std::list<uint64_t>::iterator>>
+      contents_;
+
+  struct {
+    uint64_t uploads          = 0;
+    uint64_t uploaded_bytes   = 0;
+    uint64_t duplicates       = 0;
+    uint64_t duplicated_bytes = 0;
+    uint64_t skips            = 0;
+    uint64_t skipped_bytes    = 0;
+  } stats_;
+};
+}  // namespace yaza::remote
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <wayland-server-core.h>
+#include <wayland-util.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "common.hpp"
+
+namespace yaza::remote {
+class FrameCallbackRegistry;
+
+/// wl_callback resources of a Surface or VirtualObject, done by the next
+/// session frame after they are committed
+class FrameCallbackList {
+ public:
+  DISABLE_MOVE_AND_COPY(FrameCallbackList);
+  explicit FrameCallbackList(FrameCallbackRegistry& registry);
+  ~FrameCallbackList();
+
+  void queue(wl_resource* callback_resource);
+  /// move the pending callbacks to the current list
+  /// and enroll in the registry if there are any
+  void commit();
+
+ private:
+  friend class FrameCallbackRegistry;
+  friend class UploadScope;
+  FrameCallbackRegistry& registry_;
+  wl_list                pending_;
+  wl_list                current_;
+  bool                   enrolled_ = false;
+
+  /// uploads created in an UploadScope of this list and not released yet
+  struct UploadFence {
+    uint32_t in_flight = 0;
+    uint64_t epoch     = 0;
+  };
+  std::shared_ptr<UploadFence> fence_;
+  /// forget the uploads counted before `epoch`
+  void                         sync_fence(uint64_t epoch);
+  [[nodiscard]] uint32_t       uploads_in_flight(uint64_t epoch);
+  /// consecutive session frames in which the callbacks were held
+  uint32_t                     held_frames_ = 0;
+
+  /// time of the last done which is not answered by a commit yet
+  int64_t done_msec_ = -1;
+  /// predicted time from done to the commit of the next frame
+  float   latency_msec_ = 0.F;
+  bool    has_latency_  = false;
+
+  void send_done(int64_t now_msec);
+};
+
+/// Buffers created by util::DataPool while this is alive are counted as
+/// uploads of `list`. Its callbacks are held until the remote releases
+/// them, so each client is throttled at the rate its content is delivered;
+/// they are done anyway after a few frames
+class UploadScope {
+ public:
+  DISABLE_MOVE_AND_COPY(UploadScope);
+  explicit UploadScope(FrameCallbackList& list);
+  ~UploadScope();
+
+ private:
+  FrameCallbackRegistry& registry_;
+  FrameCallbackList*     prev_;
+};
+
+/// Holds only the lists which have committed callbacks, so a session frame
+/// does not need to visit every surface and virtual object.
+/// If YAZA_STAGGER_FRAME_CALLBACKS=1, lists whose client is known to render
+/// quickly are done later in the frame, so that commits do not arrive all at
+/// once right after the tick but just before the next one
+class FrameCallbackRegistry {
+ public:
+  DISABLE_MOVE_AND_COPY(FrameCallbackRegistry);
+  explicit FrameCallbackRegistry(wl_event_loop* loop);
+  ~FrameCallbackRegistry();
+
+  /// should be called on every session frame;
+  /// the next one comes after `budget_msec`
+  void send_done(int budget_msec);
+  [[nodiscard]] size_t size() const {
+    return this->lists_.size() + this->deferred_.size();
+  }
+  /// print the latency statistics and clear them
+  void log_stats();
+
+  /// should be called by util::DataPool when a buffer is created;
+  /// the returned function should be called when the buffer is released
+  [[nodiscard]] std::function<void()> begin_upload();
+  /// uploads of the disconnected session will never be released
+  void forget_uploads() {
+    ++this->upload_epoch_;
+  }
+
+ private:
+  friend class FrameCallbackList;
+  friend class UploadScope;
+  struct Deferred {
+    FrameCallbackList* list;
+    int64_t            due_msec;
+  };
+  std::vector<FrameCallbackList*> lists_;
+  /// swapped with `lists_` while sending done to reuse the allocation
+  std::vector<FrameCallbackList*> firing_;
+  std::vector<Deferred>           deferred_;
+  wl_event_source*                timer_source_;
+  int64_t                         next_frame_msec_ = -1;
+  FrameCallbackList*              uploading_       = nullptr;
+  uint64_t                        upload_epoch_    = 0;
+
+  struct {
+    uint64_t commits      = 0;
+    uint64_t render_msec  = 0;  // done to commit
+    uint64_t waiting_msec = 0;  // commit to the next session frame
+    uint64_t staggered    = 0;
+    uint64_t held         = 0;  // frames waiting for uploads
+    uint64_t timed_out    = 0;  // done while uploads are still in flight
+  } stats_;
+
+  void enroll(FrameCallbackList* list);
+  void remove(FrameCallbackList* list);
+  void record_commit(int64_t now_msec, int64_t render_msec);
+  void send_deferred(bool all);
+};
+}  // namespace yaza::remote
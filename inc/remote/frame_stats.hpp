@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+
+#include "common.hpp"
+
+namespace yaza::remote {
+/// Counts GPU state changes (program, vertex array and texture switches)
+/// between consecutive rendering units drawn by the remote in a frame,
+/// and how far predicted rays are from the measured ones
+class FrameStats {
+ public:
+  DISABLE_MOVE_AND_COPY(FrameStats);
+  FrameStats()  = default;
+  ~FrameStats() = default;
+
+  /// a virtual object which needed `prev` state changes to be drawn
+  /// now needs `count`
+  void update_state_changes(uint32_t prev, uint32_t count) {
+    this->scene_ = this->scene_ - prev + count;
+  }
+  /// should be called after every session frame
+  void end_frame();
+  /// state changes per frame of the last frame
+  [[nodiscard]] uint32_t state_changes() const {
+    return this->last_frame_;
+  }
+  /// a ray shown at a frame deadline was `degrees` away from the pose
+  /// measured then
+  void record_prediction_error(float degrees);
+  /// mean angle (degrees) of every ray since the last reset
+  [[nodiscard]] float prediction_error() const;
+  /// print the statistics and clear them
+  void reset();
+
+ private:
+  /// state changes to draw every virtual object synced to the remote
+  uint32_t scene_      = 0;
+  uint32_t last_frame_ = 0;
+
+  struct {
+    uint64_t frames        = 0;
+    uint64_t state_changes = 0;
+    uint32_t max           = 0;
+  } stats_;
+  struct {
+    uint64_t frames = 0;
+    double   error  = 0.;  // sum of degrees
+  } prediction_;
+};
+}  // namespace yaza::remote
@@ -11,7 +11,12 @@
 #include <memory>
 
 #include "common.hpp"
+#include "remote/content_store.hpp"
+#include "remote/frame_callback.hpp"
+#include "remote/frame_stats.hpp"
+#include "remote/sampler_cache.hpp"
 #include "remote/session.hpp"
+#include "remote/shader_cache.hpp"
 #include "util/signal.hpp"
 
 namespace yaza::remote {
@@ -24,17 +29,32 @@ class Remote {
   [[nodiscard]] bool                             has_session();
   /// should be called while the session is available
   std::shared_ptr<zen::remote::server::IChannel> channel_nonnull();
+  ContentStore&                                  content_store() {
+    return this->content_store_;
+  }
+  ShaderCache& shader_cache() {
+    return this->shader_cache_;
+  }
+  SamplerCache& sampler_cache() {
+    return this->sampler_cache_;
+  }
+  FrameStats& frame_stats() {
+    return this->frame_stats_;
+  }
+  FrameCallbackRegistry& frame_callbacks() {
+    return this->frame_callbacks_;
+  }
+  /// deadline of the upcoming session frame
+  [[nodiscard]] std::chrono::steady_clock::time_point next_frame() const;
 
   void listen_session_established(util::Listener<Session*>& listener);
   void listen_session_disconnected(util::Listener<std::nullptr_t*>& listener);
-  void listen_session_frame(util::Listener<std::nullptr_t*>& listener);
 
  private:
   wl_event_loop* wl_loop_;
   struct {
     util::Signal<Session*>        session_established;
     util::Signal<std::nullptr_t*> session_disconnected;
-    util::Signal<std::nullptr_t*> session_frame;
   } events_;
 
   std::unique_ptr<zen::remote::Signal<void(uint64_t)>::Connection>
@@ -46,7 +66,15 @@ class Remote {
   std::unique_ptr<zen::remote::server::IPeerManager> peer_manager_;
   std::chrono::steady_clock::time_point              prev_frame_;
   wl_event_source*                                   frame_timer_source_;
+  ContentStore                                       content_store_;
+  ShaderCache                                        shader_cache_;
+  SamplerCache                                       sampler_cache_;
+  FrameStats                                         frame_stats_;
+  FrameCallbackRegistry                              frame_callbacks_;
 
   void disconnect();
+  /// the first session frame after `now`
+  [[nodiscard]] std::chrono::steady_clock::time_point next_frame(
+      std::chrono::steady_clock::time_point now) const;
 };
 }  // namespace yaza::remote
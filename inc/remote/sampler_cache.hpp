@@ -0,0 +1,124 @@
+#pragma once
+
+#include <GLES3/gl32.h>
+#include <zen-remote/server/channel.h>
+#include <zen-remote/server/gl-sampler.h>
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <variant>
+
+#include "common.hpp"
+
+namespace yaza::remote {
+enum class SamplerParamType : uint8_t {
+  F,
+  I,
+  FV,
+  IV,
+  IIV,
+  IUIV,
+};
+
+struct SamplerParam {
+  SamplerParamType                                      type;
+  uint32_t                                              pname;
+  std::variant<int32_t, float, std::array<uint8_t, 16>> value;
+
+  bool operator==(const SamplerParam&) const = default;
+};
+
+/// Full parameter set of a sampler; parameters which are never set
+/// are left as GL default values
+class SamplerParams {
+ public:
+  struct Info {
+    uint32_t pname;
+    size_t   size;
+  };
+  static constexpr std::array<Info, 10> kInfoTable = {{
+      {GL_TEXTURE_MIN_FILTER,   4 },
+      {GL_TEXTURE_MAG_FILTER,   4 },
+      {GL_TEXTURE_WRAP_S,       4 },
+      {GL_TEXTURE_WRAP_T,       4 },
+      {GL_TEXTURE_WRAP_R,       4 },
+      {GL_TEXTURE_MIN_LOD,      4 },
+      {GL_TEXTURE_MAX_LOD,      4 },
+      {GL_TEXTURE_COMPARE_MODE, 4 },
+      {GL_TEXTURE_COMPARE_FUNC, 4 },
+      {GL_TEXTURE_BORDER_COLOR, 16},
+  }};
+  /// return std::nullopt if `pname` is not a sampler parameter
+  static constexpr std::optional<size_t> index_of(uint32_t pname) {
+    for (size_t i = 0; i < kInfoTable.size(); ++i) {
+      if (kInfoTable.at(i).pname == pname) {
+        return i;
+      }
+    }
+    return std::nullopt;
+  }
+
+  void set(size_t index, SamplerParam&& param) {
+    this->params_.at(index) = std::move(param);
+  }
+  /// overwrite parameters with ones which are set in `other`
+  /// return true if any value is changed
+  bool merge(const SamplerParams& other);
+  [[nodiscard]] bool     empty() const;
+  [[nodiscard]] uint64_t hash() const;
+  void                   send(zen::remote::server::IGlSampler* proxy) const;
+
+  bool operator==(const SamplerParams&) const = default;
+
+ private:
+  std::array<std::optional<SamplerParam>, kInfoTable.size()> params_;
+};
+
+/// Remote sampler shared by all samplers with the same parameter set
+struct CachedSampler {
+  CachedSampler(uint64_t key, const SamplerParams& params)
+      : key(key), params(params) {
+  }
+
+  uint64_t      key;
+  SamplerParams params;
+
+  /// create the remote sampler if it has not been created in this session
+  void     sync(const std::shared_ptr<zen::remote::server::IChannel>& channel);
+  uint64_t remote_id() {
+    assert(this->proxy.has_value());
+    return this->proxy->get()->id();
+  }
+
+  std::optional<std::unique_ptr<zen::remote::server::IGlSampler>> proxy =
+      std::nullopt;
+};
+
+/// Interns samplers by their parameter set; entries outlive sessions
+/// in the same way as ShaderCache
+class SamplerCache {
+ public:
+  DISABLE_MOVE_AND_COPY(SamplerCache);
+  SamplerCache()  = default;
+  ~SamplerCache() = default;
+
+  std::shared_ptr<CachedSampler> get(const SamplerParams& params);
+
+  /// create remote samplers of all entries for the new session
+  void warm_up(const std::shared_ptr<zen::remote::server::IChannel>& channel);
+  /// drop remote samplers of the disconnected session
+  void reset_proxies();
+
+ private:
+  // multimap in order to keep entries whose keys collide
+  std::unordered_multimap<uint64_t, std::shared_ptr<CachedSampler>> samplers_;
+
+  /// remove entries which are not used by anyone if the cache is too large
+  void evict();
+};
+}  // namespace yaza::remote
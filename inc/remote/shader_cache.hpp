@@ -0,0 +1,101 @@
+#pragma once
+
+#include <zen-remote/server/channel.h>
+#include <zen-remote/server/gl-program.h>
+#include <zen-remote/server/gl-shader.h>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common.hpp"
+
+namespace yaza::remote {
+/// Remote shader shared by all shaders whose canonicalized sources are equal
+struct CachedShader {
+  CachedShader(uint64_t key, uint32_t type, std::string&& canonical,
+      std::string&& source)
+      : key(key)
+      , type(type)
+      , canonical(std::move(canonical))
+      , source(std::move(source)) {
+  }
+
+  uint64_t    key;
+  uint32_t    type;
+  std::string canonical;  // only used to find the same shader
+  // source of the shader that created the entry, sent to the remote as is;
+  // line numbers in logs of the remote match this source, and may not match
+  // other shaders which differ only in comments and whitespaces
+  std::string source;
+
+  /// create the remote shader if it has not been created in this session
+  void     sync(const std::shared_ptr<zen::remote::server::IChannel>& channel);
+  uint64_t remote_id() {
+    assert(this->proxy.has_value());
+    return this->proxy->get()->id();
+  }
+
+  std::optional<std::unique_ptr<zen::remote::server::IGlShader>> proxy =
+      std::nullopt;
+};
+
+/// Remote program shared by all programs linked with the same shaders
+struct CachedProgram {
+  CachedProgram(
+      uint64_t key, std::vector<std::shared_ptr<CachedShader>>&& shaders)
+      : key(key), shaders(std::move(shaders)) {
+  }
+
+  uint64_t                                   key;
+  std::vector<std::shared_ptr<CachedShader>> shaders;
+
+  /// create and link the remote program if it has not been created
+  /// in this session
+  void     sync(const std::shared_ptr<zen::remote::server::IChannel>& channel);
+  uint64_t remote_id() {
+    assert(this->proxy.has_value());
+    return this->proxy->get()->id();
+  }
+
+  std::optional<std::unique_ptr<zen::remote::server::IGlProgram>> proxy =
+      std::nullopt;
+};
+
+/// Cache of remote shaders and programs; entries outlive sessions so that
+/// they can be created before clients start syncing on the next session
+class ShaderCache {
+ public:
+  DISABLE_MOVE_AND_COPY(ShaderCache);
+  ShaderCache()  = default;
+  ~ShaderCache() = default;
+
+  std::shared_ptr<CachedShader> get_shader(
+      const char* source, size_t size, uint32_t type);
+  std::shared_ptr<CachedProgram> get_program(
+      std::vector<std::shared_ptr<CachedShader>>&& shaders);
+
+  /// create remote objects of entries still used by someone for the new
+  /// session
+  void warm_up(const std::shared_ptr<zen::remote::server::IChannel>& channel);
+  /// drop remote objects of the disconnected session
+  void reset_proxies();
+
+  /// strip comments, trim lines, collapse whitespaces and remove empty lines
+  static std::string canonicalize(const char* source, size_t size);
+
+ private:
+  // multimap in order to keep entries whose keys collide
+  std::unordered_multimap<uint64_t, std::shared_ptr<CachedShader>>  shaders_;
+  std::unordered_multimap<uint64_t, std::shared_ptr<CachedProgram>> programs_;
+
+  /// remove entries which are not used by anyone if the cache is too large
+  void evict();
+};
+}  // namespace yaza::remote
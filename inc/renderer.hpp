@@ -15,6 +15,8 @@
 #include <unordered_map>
 
 #include "common.hpp"
+#include "remote/sampler_cache.hpp"
+#include "remote/shader_cache.hpp"
 #include "util/data_pool.hpp"
 
 namespace yaza {
@@ -60,15 +62,13 @@ class Renderer {
   std::unique_ptr<zen::remote::server::IRenderingUnit>   rendering_unit_;
   std::unique_ptr<zen::remote::server::IGlBaseTechnique> technique_;
 
-  std::unique_ptr<zen::remote::server::IGlShader>  vert_shader_;
-  std::unique_ptr<zen::remote::server::IGlShader>  frag_shader_;
-  std::unique_ptr<zen::remote::server::IGlProgram> program_;
+  std::shared_ptr<remote::CachedProgram> program_;
 
   std::unordered_map<uint32_t, Buffer>                 buffers_;
   std::unique_ptr<zen::remote::server::IGlVertexArray> vert_array_;
 
   std::unique_ptr<zen::remote::server::IGlTexture> texture_;
-  std::unique_ptr<zen::remote::server::IGlSampler> sampler_;
+  std::shared_ptr<remote::CachedSampler>           sampler_;
   util::DataPool                                   texture_data_;
 };
 }  // namespace yaza
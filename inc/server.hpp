@@ -12,6 +12,7 @@
 
 #include "common.hpp"
 #include "input/bounded_object.hpp"
+#include "input/picking_tree.hpp"
 #include "input/server_seat.hpp"
 #include "remote/remote.hpp"
 #include "util/weakable_unique_ptr.hpp"
@@ -42,6 +43,10 @@ class Server {
       const std::function<void(util::WeakPtr<input::BoundedObject>&)>& handler);
   void foreach_bounded_app(
       const std::function<void(util::WeakPtr<input::BoundedObject>&)>& handler);
+  /// surfaces and bounded apps for ray picking
+  input::PickingTree& picking_tree() {
+    return this->picking_tree_;
+  }
 
   std::optional<util::WeakPtr<input::BoundedObject>> get_surface_from_resource(
       wl_resource* wl_surface);
@@ -54,6 +59,7 @@ class Server {
 
   std::list<util::WeakPtr<input::BoundedObject>> surfaces_;
   std::list<util::WeakPtr<input::BoundedObject>> bounded_apps_;
+  input::PickingTree                             picking_tree_;
   void                                           reorder_surfaces();
 
   bool        is_initialized_ = false;
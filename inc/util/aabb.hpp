@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <glm/common.hpp>
+#include <glm/ext/matrix_float4x4.hpp>
+#include <glm/ext/vector_float3.hpp>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace yaza::util {
+/// Axis-aligned bounding box; empty while min > max
+struct Aabb {
+  glm::vec3 min = glm::vec3(std::numeric_limits<float>::max());
+  glm::vec3 max = glm::vec3(std::numeric_limits<float>::lowest());
+
+  /// bounds of the box of `half_size` placed by `model_mat`
+  static Aabb from_obb(const glm::mat4& model_mat, const glm::vec3& half_size);
+
+  void merge(const Aabb& other) {
+    this->min = glm::min(this->min, other.min);
+    this->max = glm::max(this->max, other.max);
+  }
+  [[nodiscard]] Aabb merged(const Aabb& other) const {
+    Aabb result = *this;
+    result.merge(other);
+    return result;
+  }
+  bool operator==(const Aabb& other) const {
+    return this->min == other.min && this->max == other.max;
+  }
+  [[nodiscard]] bool empty() const {
+    return this->min.x > this->max.x || this->min.y > this->max.y ||
+           this->min.z > this->max.z;
+  }
+  /// half of the surface area, used as the cost of a node
+  [[nodiscard]] float area() const {
+    if (this->empty()) {
+      return 0.F;
+    }
+    auto d = this->max - this->min;
+    return (d.x * d.y) + (d.y * d.z) + (d.z * d.x);
+  }
+
+  /// return the distance where the ray enters the box, which is 0 if
+  /// `origin` is inside
+  /// @param inv_direction 1 / (normalized direction of the ray)
+  [[nodiscard]] std::optional<float> intersect(
+      const glm::vec3& origin, const glm::vec3& inv_direction) const;
+};
+
+/// Bounding volume hierarchy over a fixed set of boxes,
+/// rebuilt whenever the set changes
+class AabbBvh {
+ public:
+  AabbBvh() = default;
+
+  /// boxes in one leaf, which is one batch of 8-wide SIMD tests
+  static constexpr uint32_t kMaxLeafSize = 8;
+
+  void build(const std::vector<Aabb>& boxes);
+  [[nodiscard]] bool empty() const {
+    return this->nodes_.empty();
+  }
+  /// indices of the boxes in leaf order; a leaf covers `count` consecutive
+  /// entries from `first`
+  [[nodiscard]] const std::vector<uint32_t>& order() const {
+    return this->indices_;
+  }
+  using LeafTest =
+      std::function<std::optional<float>(uint32_t first, uint32_t count)>;
+  /// call `test` for every leaf the ray enters before the nearest distance
+  /// returned by `test` so far, and return the nearest one
+  std::optional<float> raycast(const glm::vec3& origin,
+      const glm::vec3& direction, const LeafTest& test) const;
+
+ private:
+  struct Node {
+    Aabb     bounds;
+    uint32_t first;  // child index of inner nodes, or index of `indices_`
+    uint32_t count;  // 0 for inner nodes
+  };
+  std::vector<Node>     nodes_;
+  std::vector<uint32_t> indices_;
+
+  void split(uint32_t node, const std::vector<Aabb>& boxes);
+};
+}  // namespace yaza::util
@@ -7,6 +7,8 @@
 #include <glm/gtx/quaternion.hpp>
 
 namespace yaza::util {
+/// Position, rotation and scale of an object. Composed matrices are cached
+/// and rebuilt on the first read after a setter is called
 class Box {
  public:
   Box() : pos_(), rot_(), scale_() {
@@ -15,53 +17,55 @@ class Box {
       : pos_(pos), rot_(rot), scale_(scale) {
   }
 
-  glm::vec3& pos() {
+  [[nodiscard]] const glm::vec3& pos() const {
     return this->pos_;
   }
-  float& x() {
-    return this->pos_.x;
-  }
-  float& y() {
-    return this->pos_.y;
-  }
-  float& z() {
-    return this->pos_.z;
-  }
-  glm::quat& rot() {
+  [[nodiscard]] const glm::quat& rot() const {
     return this->rot_;
   }
-  float& rx() {
-    return this->rot_.x;
-  }
-  float& ry() {
-    return this->rot_.y;
-  }
-  float& rz() {
-    return this->rot_.z;
-  }
-  glm::vec3& scale() {
+  [[nodiscard]] const glm::vec3& scale() const {
     return this->scale_;
   }
-  float& width() {
+  [[nodiscard]] float width() const {
     return this->scale_.x;
   }
-  float& height() {
+  [[nodiscard]] float height() const {
     return this->scale_.y;
   }
-  float& depth() {
+  [[nodiscard]] float depth() const {
     return this->scale_.z;
   }
 
-  glm::mat4 mat() {
-    return this->translation_mat() * this->rotation_mat() * this->scale_mat();
+  void set_pos(const glm::vec3& pos) {
+    this->pos_   = pos;
+    this->dirty_ = true;
   }
-  glm::mat4 translation_mat() {
-    return glm::translate(glm::mat4(1.F), this->pos_);
+  void set_rot(const glm::quat& rot) {
+    this->rot_   = rot;
+    this->dirty_ = true;
+  }
+  void set_scale(const glm::vec3& scale) {
+    this->scale_ = scale;
+    this->dirty_ = true;
+  }
+  void set_size(float width, float height) {
+    this->scale_.x = width;
+    this->scale_.y = height;
+    this->dirty_   = true;
   }
-  glm::mat4 rotation_mat() {
-    return glm::toMat4(this->rot_);
+
+  /// translation * rotation * scale
+  [[nodiscard]] const glm::mat4& mat() const;
+  /// translation * rotation, which keeps distances
+  [[nodiscard]] const glm::mat4& rigid_mat() const;
+  /// inverse of `rigid_mat()`, which brings world space into the space of
+  /// the box without scaling
+  [[nodiscard]] const glm::mat4& inverse_rigid_mat() const;
+  [[nodiscard]] const glm::mat4& rotation_mat() const;
+  [[nodiscard]] glm::mat4 translation_mat() const {
+    return glm::translate(glm::mat4(1.F), this->pos_);
   }
-  glm::mat4 scale_mat() {
+  [[nodiscard]] glm::mat4 scale_mat() const {
     return glm::scale(glm::mat4(1.F), this->scale_);
   }
 
@@ -69,5 +73,12 @@ class Box {
   glm::vec3 pos_;
   glm::quat rot_;
   glm::vec3 scale_;
+
+  mutable bool      dirty_ = true;
+  mutable glm::mat4 mat_;
+  mutable glm::mat4 rigid_mat_;
+  mutable glm::mat4 inverse_rigid_mat_;
+  mutable glm::mat4 rotation_mat_;
+  void              update_cache() const;
 };
 }  // namespace yaza::util
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+#include "common.hpp"
+
+namespace yaza::util {
+/// memory_resource counting allocations passed to `upstream`
+class CountingResource : public std::pmr::memory_resource {
+ public:
+  DISABLE_MOVE_AND_COPY(CountingResource);
+  explicit CountingResource(std::pmr::memory_resource* upstream)
+      : upstream_(upstream) {
+  }
+  ~CountingResource() override = default;
+
+  [[nodiscard]] uint64_t allocations() const {
+    return this->allocations_;
+  }
+  [[nodiscard]] uint64_t allocated_bytes() const {
+    return this->allocated_bytes_;
+  }
+
+ private:
+  std::pmr::memory_resource* upstream_;
+  uint64_t                   allocations_     = 0;
+  uint64_t                   allocated_bytes_ = 0;
+
+  void* do_allocate(size_t bytes, size_t alignment) override;
+  void  do_deallocate(void* p, size_t bytes, size_t alignment) override;
+  [[nodiscard]] bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override;
+};
+
+/// Pool for small objects created and dropped on every commit, such as
+/// bindings, uniform values, regions and shm buffers.
+/// Not thread-safe; use it only from the event loop thread
+std::pmr::memory_resource* commit_pool();
+/// print how many allocations were requested to the pool per commit
+/// and how many of them reached the heap
+void log_commit_pool_stats();
+
+/// Counts allocations made while it is alive as those of one commit
+class CommitPoolScope {
+ public:
+  DISABLE_MOVE_AND_COPY(CommitPoolScope);
+  CommitPoolScope();
+  ~CommitPoolScope();
+
+ private:
+  uint64_t requests_;
+  uint64_t heap_;
+};
+}  // namespace yaza::util
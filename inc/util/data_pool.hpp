@@ -3,7 +3,9 @@
 #include <wayland-server-core.h>
 #include <zen-remote/server/buffer.h>
 
+#include <cstdint>
 #include <memory>
+#include <optional>
 
 #include "weak_resource.hpp"
 
@@ -26,6 +28,11 @@ class DataPool {
 
   std::unique_ptr<zen::remote::server::IBuffer> create_buffer();
 
+  /// digest of the stored data, calculated at the first call after update
+  [[nodiscard]] uint64_t digest();
+  /// return true if `other` stores the same bytes as `this`
+  [[nodiscard]] bool same_content(DataPool& other);
+
   [[nodiscard]] ssize_t size() const {
     return size_;
   }
@@ -35,11 +42,13 @@ class DataPool {
   void reset() {
     this->size_ = 0;
     this->data_.reset();
+    this->digest_.reset();
   }
 
  private:
-  ssize_t               size_ = 0;
-  std::shared_ptr<void> data_;
+  ssize_t                 size_ = 0;
+  std::shared_ptr<void>   data_;
+  std::optional<uint64_t> digest_;
 
   /// renew `size_` and reallocate `data_` if the capacity is not enough
   void ensure_and_set_data_size(ssize_t size);
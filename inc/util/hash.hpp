@@ -0,0 +1,9 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace yaza::util {
+/// 64-bit digest of `size` bytes from `data` (XXH64)
+uint64_t hash_bytes(const void* data, size_t size, uint64_t seed = 0);
+}  // namespace yaza::util
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
 #include <glm/ext/matrix_float4x4.hpp>
 #include <glm/ext/vector_float3.hpp>
 #include <optional>
+#include <vector>
 
 namespace yaza::util::intersection {
 struct SurfaceInfo {
@@ -23,4 +26,34 @@ std::optional<SurfaceInfo> with_surface(const glm::vec3& origin,
 std::optional<float> with_obb(const glm::vec3& origin,
     const glm::vec3& direction, const glm::vec3& half_size,
     const glm::mat4& model_mat);
+
+/// Oriented bounding boxes in structure-of-arrays layout, so that `raycast`
+/// tests 8 boxes per iteration with AVX2 when the CPU supports it.
+/// Returns the same distances as `with_obb`
+class ObbBatch {
+ public:
+  void clear();
+  /// @param model_mat rotation and translation of the box
+  void push(const glm::mat4& model_mat, const glm::vec3& half_size);
+  [[nodiscard]] size_t size() const {
+    return this->half_size_[0].size();
+  }
+  /// return the nearest distance among the boxes in [first, first + count)
+  /// @param direction_norm normalized direction of the vector
+  std::optional<float> raycast(const glm::vec3& origin,
+      const glm::vec3& direction_norm, size_t first, size_t count) const;
+
+ private:
+  std::array<std::vector<float>, 3>                center_;
+  std::array<std::array<std::vector<float>, 3>, 3> axis_;  // [axis][xyz]
+  std::array<std::vector<float>, 3>                half_size_;
+
+  [[nodiscard]] std::optional<float> raycast_one(const glm::vec3& origin,
+      const glm::vec3& direction_norm, size_t index) const;
+#if defined(__x86_64__)
+  /// test [first, first + 8)
+  [[nodiscard]] std::optional<float> raycast_avx2(const glm::vec3& origin,
+      const glm::vec3& direction_norm, size_t first) const;
+#endif
+};
 }  // namespace yaza::util::intersection
@@ -0,0 +1,13 @@
+#pragma once
+
+namespace yaza::util {
+/// Overload set of lambdas given to std::visit.
+/// Handlers are dispatched at compile time and nothing is allocated;
+/// every alternative of the variant must be handled
+template <class... Visitors>
+struct Overloaded : Visitors... {
+  using Visitors::operator()...;
+};
+template <class... Visitors>
+Overloaded(Visitors...) -> Overloaded<Visitors...>;
+}  // namespace yaza::util
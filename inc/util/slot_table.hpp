@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "common.hpp"
+
+namespace yaza::util {
+/// Generational index table used by UniPtr/WeakPtr.
+/// A slot is acquired by an owner and its generation is bumped on release,
+/// so that a handle (index, generation) is alive only while the owner lives.
+/// Not thread-safe; all objects are owned by the wayland event loop thread
+class SlotTable {
+ public:
+  DISABLE_MOVE_AND_COPY(SlotTable);
+  SlotTable()  = default;
+  ~SlotTable() = default;
+
+  /// return the index of a free slot
+  uint32_t acquire();
+  void     release(uint32_t index);
+
+  [[nodiscard]] uint32_t generation(uint32_t index) const {
+    return this->generations_[index];
+  }
+  [[nodiscard]] bool alive(uint32_t index, uint32_t generation) const {
+    return this->generations_[index] == generation;
+  }
+
+ private:
+  std::vector<uint32_t> generations_;
+  std::vector<uint32_t> free_indices_;
+};
+
+/// one table per object type
+template <class T>
+SlotTable* slot_table() {
+  // never destroyed so that UniPtr can be released during static destruction
+  static auto* table = new SlotTable();
+  return table;
+}
+}  // namespace yaza::util
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+#include "common.hpp"
+
+namespace yaza::util {
+/// Bounded lock-free queue between exactly one producer thread and one
+/// consumer thread. Elements are stored in place, so push and pop never
+/// allocate. Each side caches the other's index to touch the shared cache
+/// line only when the queue looks full or empty
+template <class T, size_t Capacity>
+class SpscQueue {
+  static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+      "Capacity should be a power of two");
+
+ public:
+  DISABLE_MOVE_AND_COPY(SpscQueue);
+  SpscQueue()  = default;
+  ~SpscQueue() = default;
+
+  /// should be called by the producer; return false if the queue is full
+  bool push(const T& value) {
+    auto tail = this->tail_.load(std::memory_order_relaxed);
+    if (tail - this->head_cache_ == Capacity) {
+      this->head_cache_ = this->head_.load(std::memory_order_acquire);
+      if (tail - this->head_cache_ == Capacity) {
+        return false;
+      }
+    }
+    this->buffer_[tail & kMask] = value;
+    this->tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+  /// should be called by the consumer; return false if the queue is empty
+  bool pop(T& value) {
+    auto head = this->head_.load(std::memory_order_relaxed);
+    if (head == this->tail_cache_) {
+      this->tail_cache_ = this->tail_.load(std::memory_order_acquire);
+      if (head == this->tail_cache_) {
+        return false;
+      }
+    }
+    value = this->buffer_[head & kMask];
+    this->head_.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+ private:
+  static constexpr size_t kMask      = Capacity - 1;
+  static constexpr size_t kCacheLine = 64;
+
+  // consumer side
+  alignas(kCacheLine) std::atomic<size_t> head_ = 0;
+  size_t tail_cache_                            = 0;
+  // producer side
+  alignas(kCacheLine) std::atomic<size_t> tail_ = 0;
+  size_t head_cache_                            = 0;
+
+  alignas(kCacheLine) std::array<T, Capacity> buffer_;
+};
+}  // namespace yaza::util
@@ -1,53 +1,93 @@
 #pragma once
 
 #include <cassert>
+#include <concepts>
+#include <cstdint>
 #include <memory>
 #include <utility>
 
+#include "util/slot_table.hpp"
+
 namespace yaza::util {
 template <class T>
 class WeakPtr;
 
-/// std::unique_ptr that is referable by WeakPtr
+/// std::unique_ptr that is referable by WeakPtr.
+/// Each UniPtr owns a slot of the SlotTable of `T`, and WeakPtr checks
+/// the generation of the slot instead of the reference count
 template <class T>
 class UniPtr {
  public:
   template <class... Args>
   explicit UniPtr(Args&&... args)
-      : ptr_(std::make_shared<T>(std::forward<Args>(args)...)) {
+      : UniPtr(Adopt{}, new T(std::forward<Args>(args)...)) {
+  }
+  explicit UniPtr(T&& t) : UniPtr(Adopt{}, new T(std::move(t))) {
   }
-  explicit UniPtr(T&& t) : ptr_(std::make_shared(std::move(t))) {
+  template <class U>
+    requires std::derived_from<U, T>
+  explicit UniPtr(std::unique_ptr<U>&& p)
+      : UniPtr(Adopt{}, static_cast<T*>(p.release())) {
   }
-  explicit UniPtr(std::shared_ptr<T>&& p) : ptr_(std::move(p)) {
-    assert(this->ptr_.unique());
+  UniPtr(UniPtr&& other) noexcept
+      : ptr_(std::exchange(other.ptr_, nullptr)), index_(other.index_) {
+  }
+  UniPtr& operator=(UniPtr&& other) noexcept {
+    if (this != &other) {
+      this->reset();
+      this->ptr_   = std::exchange(other.ptr_, nullptr);
+      this->index_ = other.index_;
+    }
+    return *this;
+  }
+  UniPtr(const UniPtr&)            = delete;
+  UniPtr& operator=(const UniPtr&) = delete;
+  ~UniPtr() {
+    this->reset();
   }
-  UniPtr(UniPtr&& other) noexcept            = default;
-  UniPtr& operator=(UniPtr&& other) noexcept = default;
-  UniPtr(const UniPtr&)                      = delete;
-  UniPtr& operator=(const UniPtr&)           = delete;
-  ~UniPtr()                                  = default;
 
   WeakPtr<T> weak() const {
-    return WeakPtr(this->ptr_);
+    return this->weak_as<T>();
+  }
+  /// WeakPtr to the derived class `U`; `this` must own `U`
+  template <class U>
+    requires std::derived_from<U, T>
+  WeakPtr<U> weak_as() const {
+    assert(this->ptr_ && dynamic_cast<U*>(this->ptr_));
+    return WeakPtr<U>(static_cast<U*>(this->ptr_), slot_table<T>(),
+        this->index_, slot_table<T>()->generation(this->index_));
   }
 
   T* get() const {
-    return this->ptr_.get();
+    return this->ptr_;
   }
   T* operator->() const {
-    return this->ptr_.get();
+    return this->ptr_;
   }
 
  private:
-  std::shared_ptr<T> ptr_;
+  struct Adopt {};
+  UniPtr(Adopt /*tag*/, T* ptr)
+      : ptr_(ptr), index_(slot_table<T>()->acquire()) {
+  }
+  void reset() {
+    if (!this->ptr_) {
+      return;
+    }
+    // release the slot first so that WeakPtr::lock() returns nullptr
+    // while `T` is being destroyed (same as std::weak_ptr)
+    slot_table<T>()->release(this->index_);
+    delete std::exchange(this->ptr_, nullptr);
+  }
+
+  T*       ptr_;
+  uint32_t index_;
 };
 
 template <class T>
 class WeakPtr {
  public:
-  WeakPtr() = default;
-  explicit WeakPtr(std::shared_ptr<T> shared) : ptr_(shared) {
-  }
+  WeakPtr()                                    = default;
   WeakPtr(WeakPtr&& other) noexcept            = default;
   WeakPtr& operator=(WeakPtr&& other) noexcept = default;
   WeakPtr(const WeakPtr&)                      = default;
@@ -55,29 +95,38 @@ class WeakPtr {
   ~WeakPtr()                                   = default;
 
   T* lock() const {
-    if (auto p = this->ptr_.lock()) {
-      return p.get();
+    if (this->table_ && this->table_->alive(this->index_, this->generation_)) {
+      return this->ptr_;
     }
     return nullptr;
   }
   void reset() {
-    this->ptr_.reset();
+    *this = WeakPtr();
   }
   void swap(WeakPtr<T>& other) noexcept {
-    this->ptr_.swap(other.ptr_);
+    std::swap(*this, other);
   }
 
   T* operator->() const {
     return this->lock();
   }
-  bool operator==(const WeakPtr<T>& other) {
+  bool operator==(const WeakPtr<T>& other) const {
     return this->lock() == other.lock();
   }
-  bool operator!=(const WeakPtr<T>& other) {
-    return !(this == other);
+  bool operator!=(const WeakPtr<T>& other) const {
+    return !(*this == other);
   }
 
  private:
-  std::weak_ptr<T> ptr_;
+  WeakPtr(T* ptr, const SlotTable* table, uint32_t index, uint32_t generation)
+      : ptr_(ptr), table_(table), index_(index), generation_(generation) {
+  }
+  template <class>
+  friend class UniPtr;
+
+  T*               ptr_        = nullptr;
+  const SlotTable* table_      = nullptr;
+  uint32_t         index_      = 0;
+  uint32_t         generation_ = 0;
 };
 }  // namespace yaza::util
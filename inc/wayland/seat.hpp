@@ -3,7 +3,9 @@
 #include <wayland-server-core.h>
 #include <wayland-server.h>
 
+#include <cstdint>
 #include <functional>
+#include <optional>
 
 #include "common.hpp"
 
@@ -24,12 +26,25 @@ class ClientSeat {
   void data_device_foreach(
       const std::function<void(wl_resource*)>& handler) const;
   void ray_foreach(const std::function<void(wl_resource*)>& handler) const;
+  /// zwn_ray created `index`-th, which receives events of the ray `index`
+  [[nodiscard]] wl_resource* ray(uint32_t index) const;
+
+  /// wl_pointer has one focus, so it follows the first ray entering a
+  /// surface of the client until the ray leaves;
+  /// return false if another ray owns it
+  bool acquire_pointer(uint32_t ray);
+  void release_pointer(uint32_t ray);
+  [[nodiscard]] std::optional<uint32_t> pointer_ray() const {
+    return this->pointer_ray_;
+  }
 
  private:
   wl_list pointers_;      // wl_pointer
   wl_list keyboards_;     // wl_keyboard
   wl_list data_devices_;  // wl_data_device
-  wl_list rays_;          // zwn_ray
+  wl_list rays_;          // zwn_ray, in creation order
+
+  std::optional<uint32_t> pointer_ray_;
 
   wl_resource* resource_;
 };
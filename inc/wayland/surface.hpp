@@ -16,8 +16,10 @@
 
 #include "common.hpp"
 #include "input/bounded_object.hpp"
+#include "remote/frame_callback.hpp"
 #include "remote/session.hpp"
 #include "renderer.hpp"
+#include "util/aabb.hpp"
 #include "util/data_pool.hpp"
 #include "util/signal.hpp"
 
@@ -43,14 +45,16 @@ class Surface : public input::BoundedObject {
   explicit Surface(wl_resource* resource);
   ~Surface();
 
-  void enter(input::IntersectInfo& intersect_info) override;
-  void leave() override;
-  void motion(input::IntersectInfo& intersect_info) override;
-  void button(uint32_t button, wl_pointer_button_state state) override;
-  void axis(float amount) override;
-  void frame() override;
+  void enter(input::RayId ray, input::IntersectInfo& intersect_info) override;
+  void leave(input::RayId ray) override;
+  void motion(input::RayId ray, input::IntersectInfo& intersect_info) override;
+  void button(input::RayId ray, uint32_t button,
+      wl_pointer_button_state state) override;
+  void axis(input::RayId ray, float amount) override;
+  void frame(input::RayId ray) override;
   std::optional<input::IntersectInfo> check_intersection(
       const glm::vec3& origin, const glm::vec3& direction) override;
+  util::Aabb world_bounds() override;
   void move(float polar, float azimuthal) override;  // for DEFAULT
   [[nodiscard]] wl_resource* resource() const override {
     return this->resource_;
@@ -60,7 +64,7 @@ class Surface : public input::BoundedObject {
   }
 
   void attach(wl_resource* buffer);
-  void queue_frame_callback(wl_resource* resource) const;
+  void queue_frame_callback(wl_resource* resource);
   void commit();
 
   void set_role(Role role, RoleObject role_obj);
@@ -87,14 +91,12 @@ class Surface : public input::BoundedObject {
   } events_;
 
   struct {
-    std::optional<wl_resource*> buffer = std::nullopt;
-    wl_list                     frame_callback_list;
+    std::optional<wl_resource*> buffer         = std::nullopt;
     glm::ivec2                  offset         = glm::vec2(0);  // surface local
     bool                        offset_changed = false;
   } pending_;
-  struct {
-    wl_list frame_callback_list;
-  } current_;
+  remote::FrameCallbackList frame_callbacks_;
+
   glm::ivec2 offset_    = glm::vec2(0);  // surface local
   bool       is_active_ = true;          // only for CURSOR
 
@@ -106,6 +108,15 @@ class Surface : public input::BoundedObject {
   uint32_t       tex_height_;
   void           set_texture_size(uint32_t width, uint32_t height);
 
+  /// world corners of the surface quad, kept for picking so that
+  /// `check_intersection` does not rebuild `geom_.mat()` for every ray
+  struct {
+    glm::vec3 left_bottom  = glm::vec3(0.F);
+    glm::vec3 right_bottom = glm::vec3(0.F);
+    glm::vec3 left_top     = glm::vec3(0.F);
+  } corners_;
+  void geometry_changed();
+
   constexpr static float    kMinDistance = 0.4F;
   float                     distance_    = kMinDistance;  /// from origin
   float                     polar_       = std::numbers::pi / 2.F;
@@ -118,7 +129,6 @@ class Surface : public input::BoundedObject {
   [[nodiscard]] std::optional<wl_resource*> get_wl_pointer() const;
   util::Listener<remote::Session*>          session_established_listener_;
   util::Listener<std::nullptr_t*>           session_disconnected_listener_;
-  util::Listener<std::nullptr_t*>           session_frame_listener_;
   wl_resource*                              resource_;
 };
 
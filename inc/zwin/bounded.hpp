@@ -5,11 +5,16 @@
 
 #include <cstdint>
 #include <list>
+#include <memory_resource>
 #include <numbers>
 #include <unordered_map>
+#include <vector>
 
 #include "common.hpp"
 #include "input/bounded_object.hpp"
+#include "util/aabb.hpp"
+#include "util/commit_pool.hpp"
+#include "util/intersection.hpp"
 #include "util/weakable_unique_ptr.hpp"
 #include "zwin/region.hpp"
 #include "zwin/virtual_object.hpp"
@@ -23,15 +28,17 @@ class BoundedApp : public input::BoundedObject {
       zwin::virtual_object::VirtualObject* virtual_object);
   ~BoundedApp();
 
-  void enter(input::IntersectInfo& intersect_info) override;
-  void leave() override;
-  void motion(input::IntersectInfo& intersect_info) override;
-  void button(uint32_t button, wl_pointer_button_state state) override;
-  void axis(float amount) override;
-  void frame() override;
+  void enter(input::RayId ray, input::IntersectInfo& intersect_info) override;
+  void leave(input::RayId ray) override;
+  void motion(input::RayId ray, input::IntersectInfo& intersect_info) override;
+  void button(input::RayId ray, uint32_t button,
+      wl_pointer_button_state state) override;
+  void axis(input::RayId ray, float amount) override;
+  void frame(input::RayId ray) override;
 
   std::optional<input::IntersectInfo> check_intersection(
       const glm::vec3& origin, const glm::vec3& direction) override;
+  util::Aabb                 world_bounds() override;
   void                       move(float polar, float azimuthal) override;
   [[nodiscard]] wl_resource* resource() const override {
     return this->resource_;
@@ -47,13 +54,23 @@ class BoundedApp : public input::BoundedObject {
 
  private:
   struct {
-    glm::vec3                       half_size = glm::vec3(0.F);
-    std::list<region::CuboidRegion> regions;
+    glm::vec3                            half_size       = glm::vec3(0.F);
+    std::pmr::list<region::CuboidRegion> regions{util::commit_pool()};
+    bool                                 regions_changed = false;  // pending_
   } pending_, current_;
 
+  /// `current_.regions` in the space of the outer box, stored in the leaf
+  /// order of `region_tree_`
+  util::intersection::ObbBatch region_batch_;
+  util::AabbBvh                region_tree_;
+  void                         build_region_tree();
+
   zwin::virtual_object::VirtualObject* virtual_object_;
   util::Listener<std::nullptr_t*>      virtual_object_committed_listener_;
 
+  /// zwn_ray of the client which receives events of `ray`, if any
+  [[nodiscard]] wl_resource* zwn_ray(input::RayId ray) const;
+
   float polar_     = std::numbers::pi / 2.F;
   float azimuthal_ = std::numbers::pi;
   void  update_pos_and_rot();
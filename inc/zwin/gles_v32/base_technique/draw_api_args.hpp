@@ -22,7 +22,7 @@ struct DrawArraysArgs {
   DrawArraysArgs(DrawArraysArgs&&)                 = default;
   DrawArraysArgs& operator=(const DrawArraysArgs&) = default;
   DrawArraysArgs& operator=(DrawArraysArgs&&)      = default;
-  ~DrawArraysArgs();
+  ~DrawArraysArgs()                                = default;
 
   uint32_t mode;
   int32_t  first;
@@ -37,7 +37,7 @@ struct DrawElementsArgs {
   DrawElementsArgs(DrawElementsArgs&&)                 = default;
   DrawElementsArgs& operator=(const DrawElementsArgs&) = default;
   DrawElementsArgs& operator=(DrawElementsArgs&&)      = default;
-  ~DrawElementsArgs();
+  ~DrawElementsArgs()                                  = default;
 
   uint32_t                           mode;
   uint32_t                           count;
@@ -49,7 +49,7 @@ struct DrawElementsArgs {
 class DrawApiArgs {
  public:
   DISABLE_MOVE_AND_COPY(DrawApiArgs);
-  DrawApiArgs();
+  DrawApiArgs()  = default;
   ~DrawApiArgs() = default;
 
   static void commit(DrawApiArgs& pending, DrawApiArgs& current);
@@ -62,12 +62,9 @@ class DrawApiArgs {
       util::WeakPtr<gl_buffer::GlBuffer>&& element_array_buffer);
 
  private:
-  // clang-format off
-  std::variant<
-    std::unique_ptr<DrawArraysArgs>,
-    std::unique_ptr<DrawElementsArgs>,
-    std::nullopt_t
-  > data_;  // clang-format on
+  // args are held by value so that committing does not allocate
+  std::variant<DrawArraysArgs, DrawElementsArgs, std::nullopt_t> data_{
+      std::nullopt};
   bool changed_ = false;
 };
 }  // namespace yaza::zwin::gles_v32::gl_base_technique
@@ -8,8 +8,12 @@
 #include <cassert>
 #include <cstring>
 #include <list>
+#include <memory_resource>
+#include <optional>
 
 #include "common.hpp"
+#include "util/commit_pool.hpp"
+#include "util/signal.hpp"
 #include "util/weakable_unique_ptr.hpp"
 #include "zwin/gles_v32/gl_sampler.hpp"
 #include "zwin/gles_v32/gl_texture.hpp"
@@ -25,6 +29,8 @@ struct TextureBinding {
   uint32_t                             target;
   util::WeakPtr<gl_texture::GlTexture> texture;
   util::WeakPtr<gl_sampler::GlSampler> sampler;
+  /// GlSampler is replaced on the remote when its parameters are changed
+  std::optional<uint64_t> bound_sampler_id;
 };
 
 class TextureBindingList {
@@ -40,11 +46,20 @@ class TextureBindingList {
   void emplace(uint32_t binding, const char* name, uint32_t target,
       util::WeakPtr<gl_texture::GlTexture>&& texture,
       util::WeakPtr<gl_sampler::GlSampler>&& sampler);
+  /// the texture bound at the lowest binding point, or nullptr if none
+  [[nodiscard]] const gl_texture::GlTexture* primary_texture() const;
+  /// `handler` is called when any bound GlTexture or GlSampler is damaged
+  void set_damaged_handler(util::SignalHandler<std::nullptr_t*> handler);
 
  private:
-  std::list<TextureBinding> list_;
-  bool                      changed_ = false;
+  std::pmr::list<TextureBinding> list_{util::commit_pool()};
+  bool                           changed_ = false;
+
+  std::optional<util::SignalHandler<std::nullptr_t*>> damaged_handler_;
+  std::pmr::list<util::Listener<std::nullptr_t*>>     damaged_listeners_{
+      util::commit_pool()};
 
   void remove_expired();
+  void listen_damaged();
 };
 }  // namespace yaza::zwin::gles_v32::gl_base_technique
@@ -6,15 +6,24 @@
 #include <zwin-gles-v32-protocol.h>
 
 #include <cassert>
+#include <cstdint>
 #include <cstring>
+#include <list>
+#include <memory_resource>
+#include <string>
+#include <vector>
 
 #include "common.hpp"
+#include "util/commit_pool.hpp"
 
 namespace yaza::zwin::gles_v32::gl_base_technique {
 struct UniformVariable {
   UniformVariable(zwn_gl_base_technique_uniform_variable_type type,
       uint32_t location, const char* name, uint32_t col, uint32_t row,
       uint32_t count, bool transpose, void* value);
+  /// true if `other` would update the same variable with the same value;
+  /// the whole stored value is compared
+  [[nodiscard]] bool has_same_value(const UniformVariable& other) const;
 
   zwn_gl_base_technique_uniform_variable_type type;
   uint32_t                                    location;
@@ -23,7 +32,7 @@ struct UniformVariable {
   uint32_t                                    row;
   uint32_t                                    count;
   bool                                        transpose;
-  std::shared_ptr<void>                       value;  // actually unique
+  std::pmr::vector<uint8_t>                   value;  // col * row * count
   bool                                        newly_comitted = false;
 };
 
@@ -43,6 +52,6 @@ class UniformVariableList {
       uint32_t count, bool transpose, void* value);
 
  private:
-  std::list<UniformVariable> list_;
+  std::pmr::list<UniformVariable> list_{util::commit_pool()};
 };
 }  // namespace yaza::zwin::gles_v32::gl_base_technique
@@ -6,7 +6,9 @@
 #include <zwin-gles-v32-protocol.h>
 
 #include <cassert>
+#include <compare>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
 #include <memory>
 #include <optional>
@@ -28,6 +30,22 @@ class RenderingUnit;
 }
 
 namespace yaza::zwin::gles_v32::gl_base_technique {
+/// GPU state used by a technique; techniques with the same key can be drawn
+/// without switching the program, vertex array and texture
+struct StateKey {
+  uintptr_t program      = 0;
+  uintptr_t vertex_array = 0;
+  uintptr_t texture      = 0;
+
+  auto operator<=>(const StateKey&) const = default;
+  /// the number of state changes when `next` is drawn after `this`
+  [[nodiscard]] uint32_t count_changes(const StateKey& next) const {
+    return static_cast<uint32_t>(this->program != next.program) +
+           static_cast<uint32_t>(this->vertex_array != next.vertex_array) +
+           static_cast<uint32_t>(this->texture != next.texture);
+  }
+};
+
 class GlBaseTechnique {
  public:
   DISABLE_MOVE_AND_COPY(GlBaseTechnique);
@@ -42,6 +60,9 @@ class GlBaseTechnique {
     return this->proxy_->get()->id();
   }
 
+  /// key of the committed state
+  StateKey state_key();
+
   void request_bind_program(wl_resource* resource);
   void request_bind_vertex_array(wl_resource* resource);
   void request_bind_texture(uint32_t binding, const char* name, uint32_t target,
@@ -68,6 +89,17 @@ class GlBaseTechnique {
   } pending_, current_;
   bool commited_ = false;
 
+  /// true if pending state (including bound objects) has been changed
+  /// since the last commit
+  bool damaged_ = false;
+  void damage();
+  util::Listener<std::nullptr_t*> program_damaged_listener_;
+  util::Listener<std::nullptr_t*> vertex_array_damaged_listener_;
+  util::Listener<std::nullptr_t*> element_array_buffer_damaged_listener_;
+
+  /// GlProgram is replaced by the cached one on the remote when it is linked
+  std::optional<uint64_t> bound_program_id_;
+
   // nonnull; Note that GlBaseTechnique is destroyed
   // when RenderingUnit is going to be destroyed
   rendering_unit::RenderingUnit*  owner_;
@@ -27,7 +27,14 @@ class GlBuffer {
     return this->proxy_->get()->id();
   }
 
+  void listen_damaged(util::Listener<std::nullptr_t*>& listener);
+
  private:
+  struct {
+    /// emitted when pending state is changed by a request
+    util::Signal<std::nullptr_t*> damaged;
+  } events_;
+
   struct {
     uint32_t                  target;
     uint32_t                  usage;
@@ -5,8 +5,12 @@
 
 #include <list>
 #include <memory>
+#include <memory_resource>
 
 #include "common.hpp"
+#include "remote/shader_cache.hpp"
+#include "util/commit_pool.hpp"
+#include "util/signal.hpp"
 #include "util/weakable_unique_ptr.hpp"
 #include "zwin/gles_v32/gl_shader.hpp"
 
@@ -20,27 +24,51 @@ class GlProgram {
   void     commit();
   void     sync(bool force_sync);
   uint64_t remote_id() {
+    if (this->cached_) {
+      return this->cached_->remote_id();
+    }
     assert(this->proxy_.has_value());
     return this->proxy_->get()->id();
   }
 
+  /// GlPrograms sharing the same remote program have the same identity
+  [[nodiscard]] const void* identity() const {
+    if (this->cached_) {
+      return this->cached_.get();
+    }
+    return this;
+  }
+
   void request_link();
   void attach_shader(util::WeakPtr<gl_shader::GlShader>&& shader);
 
+  void listen_damaged(util::Listener<std::nullptr_t*>& listener);
+
  private:
   struct {
-    bool                                          damaged     = false;
-    bool                                          should_link = false;
-    std::list<util::WeakPtr<gl_shader::GlShader>> shaders;
+    /// emitted when pending state is changed by a request
+    util::Signal<std::nullptr_t*> damaged;
+  } events_;
+
+  struct {
+    bool                                               damaged     = false;
+    bool                                               should_link = false;
+    std::pmr::list<util::WeakPtr<gl_shader::GlShader>> shaders{
+        util::commit_pool()};
   } pending_;
   struct {
-    bool                                          linked      = false;
-    bool                                          should_link = false;
-    std::list<util::WeakPtr<gl_shader::GlShader>> shaders;
+    bool                                               linked      = false;
+    bool                                               should_link = false;
+    std::pmr::list<util::WeakPtr<gl_shader::GlShader>> shaders{
+        util::commit_pool()};
   } current_;
   wl_resource* resource_;
 
+  /// linked program shared with other GlPrograms with the same shaders
+  std::shared_ptr<remote::CachedProgram> cached_;
+
   util::Listener<std::nullptr_t*> session_disconnected_listener_;
+  /// used until the program is linked
   std::optional<std::unique_ptr<zen::remote::server::IGlProgram>> proxy_ =
       std::nullopt;
 };
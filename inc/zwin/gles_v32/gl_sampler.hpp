@@ -3,33 +3,16 @@
 #include <wayland-server-core.h>
 #include <zen-remote/server/gl-sampler.h>
 
-#include <array>
 #include <cassert>
 #include <cstdint>
 #include <memory>
-#include <unordered_map>
 #include <variant>
 
 #include "common.hpp"
+#include "remote/sampler_cache.hpp"
 #include "util/signal.hpp"
 
 namespace yaza::zwin::gles_v32::gl_sampler {
-enum class ParamType : uint8_t {
-  F,
-  I,
-  FV,
-  IV,
-  IIV,
-  IUIV,
-};
-
-struct Parameter {
-  bool                                                  changed;
-  ParamType                                             type;
-  uint32_t                                              pname;
-  std::variant<int32_t, float, std::array<uint8_t, 16>> param;
-};
-
 class GlSampler {
  public:
   DISABLE_MOVE_AND_COPY(GlSampler);
@@ -39,21 +22,28 @@ class GlSampler {
   void     commit();
   void     sync(bool force_sync);
   uint64_t remote_id() {
-    assert(this->proxy_.has_value());
-    return this->proxy_->get()->id();
+    assert(this->cached_);
+    return this->cached_->remote_id();
   }
 
-  void set_paramater(wl_resource* resource, ParamType type, uint32_t pname,
-      std::variant<int32_t, float, wl_array*> param);
+  void set_paramater(wl_resource* resource, remote::SamplerParamType type,
+      uint32_t pname, std::variant<int32_t, float, wl_array*> param);
+
+  void listen_damaged(util::Listener<std::nullptr_t*>& listener);
 
  private:
   struct {
-    std::unordered_map<uint32_t, Parameter> params;
+    /// emitted when pending state is changed by a request
+    util::Signal<std::nullptr_t*> damaged;
+  } events_;
+
+  struct {
+    remote::SamplerParams params;
   } pending_, current_;
 
-  util::Listener<std::nullptr_t*> session_disconnected_listener_;
-  std::optional<std::unique_ptr<zen::remote::server::IGlSampler>> proxy_ =
-      std::nullopt;
+  /// remote sampler shared with other samplers with the same parameters;
+  /// replaced when any parameter is changed
+  std::shared_ptr<remote::CachedSampler> cached_;
 };
 
 void create(wl_client* client, uint32_t id);
@@ -7,10 +7,10 @@
 
 #include <cassert>
 #include <cstddef>
-#include <optional>
+#include <memory>
 
 #include "common.hpp"
-#include "util/signal.hpp"
+#include "remote/shader_cache.hpp"
 #include "zwin/shm/shm_buffer.hpp"
 
 // Do not include `gl_program.hpp` to prevent circular reference
@@ -28,18 +28,17 @@ class GlShader {
 
   void     sync();
   uint64_t remote_id() {
-    assert(this->proxy_.has_value());
-    return this->proxy_->get()->id();
+    return this->cached_->remote_id();
+  }
+  [[nodiscard]] const std::shared_ptr<remote::CachedShader>& cached() const {
+    return this->cached_;
   }
 
  private:
-  uint32_t                     type_;
-  zwin::shm_buffer::ShmBuffer* buffer_;
+  /// shared with other GlShaders whose sources are equivalent
+  std::shared_ptr<remote::CachedShader> cached_;
 
-  wl_resource*                    resource_;
-  util::Listener<std::nullptr_t*> session_disconnected_listener_;
-  std::optional<std::unique_ptr<zen::remote::server::IGlShader>> proxy_ =
-      std::nullopt;
+  wl_resource* resource_;
 };
 
 void create(wl_client* client, uint32_t id, wl_resource* buffer, uint32_t type);
@@ -22,6 +22,8 @@ struct Image2dData {
   int32_t  border;
   uint32_t format;
   uint32_t type;
+
+  bool operator==(const Image2dData&) const = default;
 };
 
 class GlTexture {
@@ -40,7 +42,14 @@ class GlTexture {
   void new_image_2d(Image2dData& image_2d, wl_resource* data);
   void request_generate_mipmap(uint32_t target);
 
+  void listen_damaged(util::Listener<std::nullptr_t*>& listener);
+
  private:
+  struct {
+    /// emitted when pending state is changed by a request
+    util::Signal<std::nullptr_t*> damaged;
+  } events_;
+
   struct {
     Image2dData               image_2d;
     util::WeakResource<void*> data;
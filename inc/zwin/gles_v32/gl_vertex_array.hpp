@@ -3,16 +3,41 @@
 #include <wayland-server-core.h>
 #include <zen-remote/server/gl-vertex-array.h>
 
+#include <array>
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 #include "common.hpp"
 #include "util/signal.hpp"
+#include "util/weakable_unique_ptr.hpp"
+#include "zwin/gles_v32/gl_buffer.hpp"
 
 namespace yaza::zwin::gles_v32::gl_vertex_array {
-struct VertexAttribute;
+/// OpenGL ES 3.2 guarantees that GL_MAX_VERTEX_ATTRIBS is at least 16.
+/// Attributes below it use fixed slots with dirty bits; larger indices,
+/// which the remote may still support, are kept in a map
+constexpr uint32_t kMaxVertexAttribs = 16;
+
+struct VertexAttribute {
+  int32_t                            size;
+  uint32_t                           type;
+  int32_t                            stride;
+  uint64_t                           offset;
+  bool                               normalized;
+  bool                               gl_buffer_changed = false;
+  util::WeakPtr<gl_buffer::GlBuffer> gl_buffer;
+
+  bool enability_changed = false;
+  bool enabled           = false;
+  void set_enability(bool enabled) {
+    this->enability_changed = true;
+    this->enabled           = enabled;
+  }
+};
 
 class GlVertexArray {
  public:
@@ -28,11 +53,42 @@ class GlVertexArray {
   }
 
   VertexAttribute& get_pending_attribute(uint32_t index);
+  /// propagate damages of `buffer` bound to the attribute at `index`
+  void listen_buffer_damaged(uint32_t index, gl_buffer::GlBuffer* buffer);
+
+  void listen_damaged(util::Listener<std::nullptr_t*>& listener);
 
  private:
   struct {
-    std::unordered_map<uint32_t, VertexAttribute> attribute_map;
+    /// emitted when pending state (including bound GlBuffers) is changed
+    util::Signal<std::nullptr_t*> damaged;
+  } events_;
+
+  /// N-th bit corresponds to N-th attribute
+  using AttributeMask = uint32_t;
+  static_assert(kMaxVertexAttribs <= sizeof(AttributeMask) * 8);
+
+  struct {
+    std::array<VertexAttribute, kMaxVertexAttribs> attributes;
+    AttributeMask                                  dirty = 0;
+    /// index is not less than kMaxVertexAttribs; committed every time
+    std::unordered_map<uint32_t, VertexAttribute> extra_attributes;
   } pending_, current_;
+  /// attributes that have been committed at least once
+  AttributeMask used_ = 0;
+  /// attributes whose GlBuffer is damaged since the last commit
+  AttributeMask buffer_damaged_ = 0;
+  /// attributes whose GlBuffer may have to be synced
+  AttributeMask buffer_not_synced_ = 0;
+
+  /// GlBuffers referred by `current_.attributes`, without duplication;
+  /// every one of them is synced on a forced sync
+  std::vector<util::WeakPtr<gl_buffer::GlBuffer>> buffers_;
+  void                                            update_buffers();
+  std::array<util::Listener<std::nullptr_t*>, kMaxVertexAttribs>
+      buffer_damaged_listeners_;
+  std::unordered_map<uint32_t, util::Listener<std::nullptr_t*>>
+      extra_buffer_damaged_listeners_;
 
   util::Listener<std::nullptr_t*> session_disconnected_listener_;
   std::optional<std::unique_ptr<zen::remote::server::IGlVertexArray>> proxy_ =
@@ -35,7 +35,12 @@ class RenderingUnit {
   void set_technique(
       std::optional<gl_base_technique::GlBaseTechnique*> technique);
 
+  /// key of the technique's committed state
+  gl_base_technique::StateKey state_key();
+
   void listen_commited(util::Listener<std::nullptr_t*>& listener);
+  /// request the owner to commit and sync `this` in the next commit
+  void damage();
 
  private:
   struct {
@@ -43,11 +48,11 @@ class RenderingUnit {
   } events_;
 
   bool committed_ = false;
+  bool damaged_   = false;
 
   // nonnull; Note that RenderingUnit is destroyed
   // when VirtualObject is going to be destroyed
-  virtual_object::VirtualObject*  owner_;
-  util::Listener<std::nullptr_t*> owner_committed_listener_;
+  virtual_object::VirtualObject* owner_;
 
   std::optional<gl_base_technique::GlBaseTechnique*> technique_;
 
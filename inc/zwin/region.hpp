@@ -8,8 +8,10 @@
 #include <glm/ext/quaternion_float.hpp>
 #include <glm/ext/vector_float3.hpp>
 #include <list>
+#include <memory_resource>
 
 #include "common.hpp"
+#include "util/commit_pool.hpp"
 
 namespace yaza::zwin::region {
 struct CuboidRegion {
@@ -26,7 +28,7 @@ class Region {
 
   void add_cuboid(glm::vec3 half_size, glm::vec3 center, glm::quat quat);
 
-  std::list<CuboidRegion> regions;
+  std::pmr::list<CuboidRegion> regions{util::commit_pool()};
 
  private:
   wl_resource* resource_;
@@ -8,11 +8,14 @@
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
+#include <list>
 #include <memory>
 #include <optional>
+#include <vector>
 
 #include "common.hpp"
 #include "input/bounded_object.hpp"
+#include "remote/frame_callback.hpp"
 #include "remote/session.hpp"
 #include "util/signal.hpp"
 #include "util/weakable_unique_ptr.hpp"
@@ -38,7 +41,9 @@ class VirtualObject {
   void set_app(std::optional<util::UniPtr<input::BoundedObject>*> app);
   void add_rendering_unit(gles_v32::rendering_unit::RenderingUnit* unit);
   void remove_rendering_unit(gles_v32::rendering_unit::RenderingUnit* unit);
-  void queue_frame_callback(wl_resource* callback_resource) const;
+  /// `unit` will be committed and synced in the next commit
+  void damage_rendering_unit(gles_v32::rendering_unit::RenderingUnit* unit);
+  void queue_frame_callback(wl_resource* callback_resource);
 
   void listen_commited(util::Listener<std::nullptr_t*>& listener);
 
@@ -48,16 +53,23 @@ class VirtualObject {
   } events_;
 
   struct {
-    wl_list frame_callback_list;
+    std::vector<gles_v32::rendering_unit::RenderingUnit*> damaged_units;
   } pending_, current_;
+  remote::FrameCallbackList frame_callbacks_;
   bool committed_  = false;
   bool destroying_ = false;
 
   std::optional<util::UniPtr<input::BoundedObject>*>  app_;
+  /// The remote draws rendering units in the order they are created,
+  /// which is the same as the order of this list
   std::list<gles_v32::rendering_unit::RenderingUnit*> rendering_unit_list_;
+  /// state changes needed to draw `rendering_unit_list_` in order
+  uint32_t state_changes_ = 0;
+  /// group units added after the first `known_units` units by GPU state
+  void sort_new_rendering_units(size_t known_units);
+  void count_state_changes();
   util::Listener<remote::Session*> session_established_listener_;
   util::Listener<std::nullptr_t*>  session_disconnected_listener_;
-  util::Listener<std::nullptr_t*>  session_frame_listener_;
   std::optional<std::unique_ptr<zen::remote::server::IVirtualObject>> proxy_ =
       std::nullopt;
   wl_resource* resource_;
@@ -0,0 +1,18 @@
+#include "input/bounded_object.hpp"
+
+#include "input/picking_tree.hpp"
+
+namespace yaza::input {
+BoundedObject::~BoundedObject() {
+  if (this->picking_tree_ != nullptr) {
+    this->picking_tree_->remove(this->picking_leaf_);
+  }
+}
+
+void BoundedObject::bounds_changed() {
+  // not inserted yet while the derived class is being constructed
+  if (this->picking_tree_ != nullptr) {
+    this->picking_tree_->update(this->picking_leaf_, this->world_bounds());
+  }
+}
+}  // namespace yaza::input
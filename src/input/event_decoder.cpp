@@ -0,0 +1,92 @@
+#include "input/event_decoder.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+
+#include "common.hpp"
+
+namespace yaza::input {
+namespace {
+uint32_t read_magic(const uint8_t* p) {
+  return (static_cast<uint32_t>(p[0]) << 24) |  // NOLINT
+         (static_cast<uint32_t>(p[1]) << 16) |  // NOLINT
+         (static_cast<uint32_t>(p[2]) << 8) |   // NOLINT
+         static_cast<uint32_t>(p[3]);           // NOLINT
+}
+}  // namespace
+
+std::span<uint8_t> EventDecoder::writable() {
+  if (this->head_ == this->tail_) {
+    this->head_ = this->tail_ = 0;
+  } else if (this->tail_ == kBufferSize) {
+    // move the incomplete Event to the front
+    std::memmove(this->buffer_.data(), this->buffer_.data() + this->head_,
+        this->readable());
+    this->tail_ = this->readable();
+    this->head_ = 0;
+  }
+  return {this->buffer_.data() + this->tail_, kBufferSize - this->tail_};
+}
+
+bool EventDecoder::next(Event& event) {
+  while (true) {
+    const uint8_t* p = this->buffer_.data() + this->head_;
+    if (this->batch_remaining_ > 0) {
+      if (this->readable() < sizeof(BatchedEvent)) {
+        return false;
+      }
+      BatchedEvent batched;
+      std::memcpy(&batched, p, sizeof(batched));
+      this->head_ += sizeof(batched);
+      --this->batch_remaining_;
+      event = {kEventMagic, batched.type, batched.data};
+      if (this->accept(event)) {
+        return true;
+      }
+      continue;
+    }
+
+    if (this->readable() < sizeof(Event)) {
+      return false;
+    }
+    if (read_magic(p) != kEventMagic) {
+      if (!this->resyncing_) {
+        LOG_WARN("received an invalid data (magic -> expect: 0x%x, actual: "
+                 "0x%x); skipping to the next magic",
+            kEventMagic, read_magic(p));
+        this->resyncing_ = true;
+      }
+      ++this->head_;
+      continue;
+    }
+    this->resyncing_ = false;
+    std::memcpy(&event, p, sizeof(event));
+    this->head_ += sizeof(event);
+    if (event.type != EventType::BATCH) {
+      if (this->accept(event)) {
+        return true;
+      }
+      continue;
+    }
+    if (event.data.count > kMaxBatchedEvents) {
+      LOG_WARN("too many batched events: %u", event.data.count);
+      continue;
+    }
+    this->batch_remaining_ = event.data.count;
+  }
+}
+
+bool EventDecoder::accept(const Event& event) {
+  if (event.type != EventType::SELECT_RAY) {
+    return true;
+  }
+  if (event.data.ray < kMaxRays) {
+    this->ray_ = event.data.ray;
+  } else {
+    LOG_WARN("invalid ray: %u", event.data.ray);
+  }
+  return false;
+}
+}  // namespace yaza::input
@@ -6,39 +6,91 @@
 #include <fcntl.h>
 #include <linux/input-event-codes.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <pthread.h>
 #include <sys/epoll.h>
+#include <poll.h>
 #include <sys/fcntl.h>
+#include <sys/eventfd.h>
 #include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
 #include <wayland-server-protocol.h>
 
+#include <array>
+#include <atomic>
 #include <cerrno>
-#include <chrono>
 #include <csignal>
 #include <cstdint>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
+#include <span>
+#include <string>
 #include <thread>
 
 #include "common.hpp"
 #include "server.hpp"
 
 namespace yaza::input {
-InputListenServer::InputListenServer() {
-// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
+namespace {
+constexpr int kListenBacklog  = 8;
+constexpr int kMaxEpollEvents = 16;
+constexpr int kAcceptFlags    = SOCK_CLOEXEC | SOCK_NONBLOCK;
+/// sequence number and Events, which fits in the decoder buffer
+constexpr size_t kMaxDatagramSize = 2048;
+/// origin of a PING whose stream client has been disconnected
+constexpr uint64_t kNoOrigin = UINT64_MAX;
+
+/// set YAZA_RAW_MOTION=1 to pass every MOUSE_MOVE to the seat
+bool should_coalesce_motion() {
+  static const bool kEnabled = [] {
+    const char* env = std::getenv("YAZA_RAW_MOTION");
+    return env == nullptr || std::strcmp(env, "1") != 0;
+  }();
+  return kEnabled;
+}
+
+Transport transport_from_env() {
+  const char* env = std::getenv("YAZA_INPUT_TRANSPORT");
+  if (env == nullptr || std::strcmp(env, "tcp") == 0) {
+    return Transport::TCP;
+  }
+  if (std::strcmp(env, "udp") == 0) {
+    return Transport::UDP;
+  }
+  if (std::strcmp(env, "unix") == 0) {
+    return Transport::UNIX;
+  }
+  LOG_WARN("Unknown YAZA_INPUT_TRANSPORT `%s`; using tcp", env);
+  return Transport::TCP;
+}
+std::string unix_socket_path() {
+  if (const char* path = std::getenv("YAZA_INPUT_SOCKET")) {
+    return path;
+  }
+  const char* runtime_dir = std::getenv("XDG_RUNTIME_DIR");
+  return std::string(runtime_dir != nullptr ? runtime_dir : "/tmp") +
+         "/yaza-input";
+}
+
+// NOLINTBEGIN(cppcoreguidelines-macro-usage)
 #define BAIL(err_prefix)                                                       \
   LOG_ERR(err_prefix ": %s", std::strerror(errno));                            \
-  return
+  close(fd);                                                                   \
+  return -1
+// NOLINTEND(cppcoreguidelines-macro-usage)
 
-  this->socket_ = socket(PF_INET, SOCK_STREAM, IPPROTO_TCP);
-  if (this->socket_ == -1) {
-    BAIL("Failed to create a socket");
-  }
-  if (fcntl(this->socket_, F_SETFL, O_NONBLOCK) == -1) {
-    BAIL("Failed to set O_NONBLOCK to socket");
+/// return a non-blocking socket listening (SOCK_STREAM) or bound
+/// (SOCK_DGRAM) at kServerPort, or -1
+int open_inet_socket(int type) {
+  int fd = socket(PF_INET, type | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+  if (fd == -1) {
+    LOG_ERR("Failed to create a socket: %s", std::strerror(errno));
+    return -1;
   }
   int opt = 1;
-  if (setsockopt(this->socket_, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt))) {
+  if (setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt))) {
     LOG_WARN("Failed set SO_REUSEADDR to socket: %s", std::strerror(errno));
   }
   sockaddr_in addr;
@@ -47,12 +99,135 @@ InputListenServer::InputListenServer() {
   addr.sin_port        = htons(kServerPort);
   addr.sin_addr.s_addr = htonl(INADDR_ANY);
 
-  if (bind(this->socket_, (const sockaddr*)&addr, sizeof(addr)) == -1) {
+  if (bind(fd, (const sockaddr*)&addr, sizeof(addr)) == -1) {
+    BAIL("Failed to bind a socket");
+  }
+  if (type == SOCK_STREAM && listen(fd, kListenBacklog) == -1) {
+    BAIL("Failed to listen a socket");
+  }
+  return fd;
+}
+/// return a non-blocking SOCK_SEQPACKET socket listening at `path`, or -1
+int open_unix_socket(const std::string& path) {
+  sockaddr_un addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(addr.sun_path)) {
+    LOG_ERR("Input socket path is too long: %s", path.c_str());
+    return -1;
+  }
+  std::memcpy(addr.sun_path, path.c_str(), path.size());
+
+  int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+  if (fd == -1) {
+    LOG_ERR("Failed to create a socket: %s", std::strerror(errno));
+    return -1;
+  }
+  unlink(path.c_str());  // left by a previous instance
+  if (bind(fd, (const sockaddr*)&addr, sizeof(addr)) == -1) {
     BAIL("Failed to bind a socket");
   }
-  if (listen(this->socket_, 2) == -1) {
+  if (listen(fd, kListenBacklog) == -1) {
     BAIL("Failed to listen a socket");
   }
+  return fd;
+}
+#undef BAIL
+
+/// should be called by the main thread
+void dispatch(uint32_t ray, const Event& event) {
+  switch (event.type) {
+    case EventType::MOUSE_MOVE:
+      server::get().seat->move_rel_pointing(ray,
+          -event.data.movement[1] / kMouseMovementDivider,
+          -event.data.movement[0] / kMouseMovementDivider);
+      break;
+    case EventType::MOUSE_DOWN:
+      if (event.data.button == BTN_LEFT || event.data.button == BTN_RIGHT) {
+        server::get().seat->handle_mouse_button(
+            ray, event.data.button, WL_POINTER_BUTTON_STATE_PRESSED);
+      }
+      break;
+    case EventType::MOUSE_UP:
+      if (event.data.button == BTN_LEFT || event.data.button == BTN_RIGHT) {
+        server::get().seat->handle_mouse_button(
+            ray, event.data.button, WL_POINTER_BUTTON_STATE_RELEASED);
+      }
+      break;
+    case EventType::MOUSE_WHEEL:
+      server::get().seat->handle_mouse_wheel(ray, event.data.wheel_amount);
+      break;
+    default:
+      LOG_WARN("Unknown event type: %u", static_cast<uint32_t>(event.type));
+      break;
+  }
+}
+}  // namespace
+
+InputListenServer::InputListenServer() : transport_(transport_from_env()) {
+// NOLINTNEXTLINE(cppcoreguidelines-macro-usage)
+#define BAIL(err_prefix)                                                       \
+  LOG_ERR(err_prefix ": %s", std::strerror(errno));                            \
+  return
+
+  switch (this->transport_) {
+    case Transport::TCP:
+      this->socket_ = open_inet_socket(SOCK_STREAM);
+      break;
+    case Transport::UDP:
+      this->socket_ = open_inet_socket(SOCK_DGRAM);
+      break;
+    case Transport::UNIX:
+      this->unix_path_ = unix_socket_path();
+      this->socket_    = open_unix_socket(this->unix_path_);
+      break;
+  }
+  if (this->socket_ == -1) {
+    return;
+  }
+
+  this->epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+  if (this->epoll_fd_ == -1) {
+    BAIL("Failed to create an epoll instance");
+  }
+  this->wake_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (this->wake_fd_ == -1) {
+    BAIL("Failed to create an eventfd");
+  }
+  for (int fd : {this->socket_, this->wake_fd_}) {
+    epoll_event ev{};
+    ev.events  = EPOLLIN;
+    ev.data.fd = fd;
+    if (epoll_ctl(this->epoll_fd_, EPOLL_CTL_ADD, fd, &ev) == -1) {
+      BAIL("Failed to add a fd to epoll");
+    }
+  }
+
+  this->notify_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (this->notify_fd_ == -1) {
+    BAIL("Failed to create an eventfd");
+  }
+  this->space_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (this->space_fd_ == -1) {
+    BAIL("Failed to create an eventfd");
+  }
+  this->pong_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+  if (this->pong_fd_ == -1) {
+    BAIL("Failed to create an eventfd");
+  }
+  {
+    epoll_event ev{};
+    ev.events  = EPOLLIN;
+    ev.data.fd = this->pong_fd_;
+    if (epoll_ctl(this->epoll_fd_, EPOLL_CTL_ADD, this->pong_fd_, &ev) == -1) {
+      BAIL("Failed to add a fd to epoll");
+    }
+  }
+  this->notify_source_ = wl_event_loop_add_fd(server::get().loop(),
+      this->notify_fd_, WL_EVENT_READABLE, dispatch_events, this);
+  if (this->notify_source_ == nullptr) {
+    BAIL("Failed to add an eventfd to the event loop");
+  }
 
   this->thread_ = std::thread([this] {
     {
@@ -62,102 +237,380 @@ InputListenServer::InputListenServer() {
       pthread_sigmask(SIG_BLOCK, &mask, nullptr);
     }
 
-    while (!this->terminate_requested_) {
-      sockaddr_in client_addr;
-      memset(&client_addr, 0, sizeof(client_addr));
-      socklen_t len = 0;
-      int       client =
-          accept4(this->socket_, (sockaddr*)&client_addr, &len, SOCK_CLOEXEC);
-      if (client == -1) {
-        if (errno == EAGAIN || errno == EWOULDBLOCK) {
-          std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    std::array<epoll_event, kMaxEpollEvents> events;
+    bool                                     running = true;
+    while (running && !this->stopping_) {
+      int n = epoll_wait(this->epoll_fd_, events.data(), events.size(), -1);
+      if (n == -1) {
+        if (errno == EINTR) {
           continue;
         }
-        BAIL("Failed to accept a client");
-      }
-      if (fcntl(client, F_SETFL, O_NONBLOCK) == -1) {
-        LOG_WARN("Failed to set O_NONBLOCK to client");
-        close(client);
-        continue;
+        LOG_ERR("Failed to wait for input events: %s", std::strerror(errno));
+        break;
       }
-      LOG_INFO(
-          "Connected with input client: %s", inet_ntoa(client_addr.sin_addr));
-      this->handle_events(client);
-      if (close(client) == -1) {
-        LOG_WARN("Failed to close client properly: %s", std::strerror(errno));
+      for (int i = 0; i < n; ++i) {
+        int fd = events.at(i).data.fd;
+        if (fd == this->wake_fd_) {
+          running = false;
+        } else if (fd == this->pong_fd_) {
+          this->send_pongs();
+        } else if (fd == this->socket_) {
+          if (this->transport_ == Transport::UDP) {
+            this->receive_datagrams();
+          } else {
+            this->accept_clients();
+          }
+        } else if (!this->handle_events(fd) ||
+                   (events.at(i).events & (EPOLLHUP | EPOLLERR)) != 0) {
+          this->disconnect(fd);
+        }
       }
-      LOG_INFO("Disconnected with %s", inet_ntoa(client_addr.sin_addr));
-    }
-    if (close(this->socket_) == -1) {
-      LOG_WARN("Failed to close socket properly: %s", std::strerror(errno));
+      this->notify_events();
     }
+    this->close_fds();
   });
 
-  LOG_INFO("InputListenServer is started (port: %d)", kServerPort);
+  if (this->transport_ == Transport::UNIX) {
+    LOG_INFO("InputListenServer is started (unix: %s)",
+        this->unix_path_.c_str());
+  } else {
+    LOG_INFO("InputListenServer is started (%s port: %d)",
+        this->transport_ == Transport::TCP ? "tcp" : "udp", kServerPort);
+  }
+#undef BAIL
 }
 
 InputListenServer::~InputListenServer() {
-  this->terminate_requested_ = true;
   if (this->thread_.joinable()) {
+    uint64_t one = 1;
+    if (write(this->wake_fd_, &one, sizeof(one)) == -1) {
+      LOG_WARN("Failed to wake input thread: %s", std::strerror(errno));
+    }
     this->thread_.join();
+  } else {
+    this->close_fds();
+  }
+  if (this->notify_source_ != nullptr) {
+    wl_event_source_remove(this->notify_source_);
+  }
+  for (int fd : {this->notify_fd_, this->space_fd_, this->pong_fd_}) {
+    if (fd != -1) {
+      close(fd);
+    }
+  }
+}
+
+void InputListenServer::accept_clients() {
+  while (true) {
+    sockaddr_storage client_addr;
+    memset(&client_addr, 0, sizeof(client_addr));
+    socklen_t len    = sizeof(client_addr);
+    int       client =
+        accept4(this->socket_, (sockaddr*)&client_addr, &len, kAcceptFlags);
+    if (client == -1) {
+      if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+        LOG_WARN("Failed to accept a client: %s", std::strerror(errno));
+      }
+      return;
+    }
+    epoll_event ev{};
+    ev.events  = EPOLLIN | EPOLLRDHUP;
+    ev.data.fd = client;
+    if (epoll_ctl(this->epoll_fd_, EPOLL_CTL_ADD, client, &ev) == -1) {
+      LOG_WARN("Failed to add input client to epoll: %s", std::strerror(errno));
+      close(client);
+      continue;
+    }
+    auto& entry = this->clients_[client];
+    if (client_addr.ss_family == AF_INET) {
+      entry.address = inet_ntoa(((sockaddr_in*)&client_addr)->sin_addr);
+      int opt       = 1;
+      if (setsockopt(client, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt))) {
+        LOG_WARN("Failed set TCP_NODELAY to client: %s", std::strerror(errno));
+      }
+    } else {
+      entry.address = this->unix_path_;
+    }
+    LOG_INFO("Connected with input client: %s (clients: %zu)",
+        entry.address.c_str(), this->clients_.size());
+  }
+}
+
+void InputListenServer::receive_datagrams() {
+  std::array<uint8_t, kMaxDatagramSize> buf;
+  while (true) {
+    sockaddr_in sender;
+    socklen_t   len  = sizeof(sender);
+    ssize_t     size = recvfrom(
+        this->socket_, buf.data(), buf.size(), 0, (sockaddr*)&sender, &len);
+    if (size == -1) {
+      if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+        LOG_WARN("Failed to receive a datagram: %s", std::strerror(errno));
+      }
+      return;
+    }
+    uint32_t sequence = 0;
+    if (size < (ssize_t)sizeof(sequence)) {
+      continue;
+    }
+    std::memcpy(&sequence, buf.data(), sizeof(sequence));
+
+    uint64_t key = ((uint64_t)sender.sin_addr.s_addr << 16) | sender.sin_port;
+    auto [it, inserted] = this->sequences_.try_emplace(key, sequence);
+    // a datagram older than the latest one of the sender arrived out of
+    // order; its buttons must not be handled after newer ones either
+    if (!inserted && (int32_t)(sequence - it->second) <= 0) {
+      ++this->stale_datagrams_;
+      continue;
+    }
+    it->second = sequence;
+
+    auto payload = std::span(buf).subspan(
+        sizeof(sequence), static_cast<size_t>(size) - sizeof(sequence));
+    this->datagram_decoder_.reset();
+    auto writable = this->datagram_decoder_.writable();
+    std::memcpy(writable.data(), payload.data(), payload.size());
+    this->datagram_decoder_.commit(payload.size());
+    this->queue_decoded(this->datagram_decoder_, key);
+    if (this->stopping_) {
+      return;
+    }
+  }
+}
+
+void InputListenServer::disconnect(int client) {
+  epoll_ctl(this->epoll_fd_, EPOLL_CTL_DEL, client, nullptr);
+  if (close(client) == -1) {
+    LOG_WARN("Failed to close client properly: %s", std::strerror(errno));
+  }
+  LOG_INFO("Disconnected with %s", this->clients_[client].address.c_str());
+  this->clients_.erase(client);
+  // the fd may be reused by the next client
+  for (auto& ping : this->pings_) {
+    if (ping.origin == (uint64_t)client) {
+      ping.origin = kNoOrigin;
+    }
+  }
+}
+
+void InputListenServer::send_pongs() {
+  uint64_t count = 0;
+  if (read(this->pong_fd_, &count, sizeof(count)) == -1 && errno != EAGAIN) {
+    LOG_WARN("Failed to read input eventfd: %s", std::strerror(errno));
+  }
+  // PINGs are handled in the order they are queued
+  uint32_t handled = this->handled_pings_.exchange(0);
+  for (; handled > 0 && !this->pings_.empty(); --handled) {
+    auto ping = this->pings_.front();
+    this->pings_.pop_front();
+    if (ping.origin == kNoOrigin) {
+      continue;
+    }
+    Event pong{htonl(kEventMagic), EventType::PING, {}};
+    pong.data.token = ping.token;
+
+    // a sender which does not read replies must not block this thread
+    ssize_t sent = -1;
+    if (this->transport_ == Transport::UDP) {
+      sockaddr_in addr;
+      std::memset(&addr, 0, sizeof(addr));
+      addr.sin_family      = AF_INET;
+      addr.sin_addr.s_addr = (uint32_t)(ping.origin >> 16);
+      addr.sin_port        = (uint16_t)(ping.origin & 0xffff);
+
+      sent = sendto(this->socket_, &pong, sizeof(pong), MSG_DONTWAIT,
+          (const sockaddr*)&addr, sizeof(addr));
+    } else {
+      sent = send((int)ping.origin, &pong, sizeof(pong),
+          MSG_DONTWAIT | MSG_NOSIGNAL);
+    }
+    if (sent == -1 && errno != EAGAIN && errno != EWOULDBLOCK) {
+      LOG_WARN("Failed to send back PING: %s", std::strerror(errno));
+    }
+  }
+}
+
+void InputListenServer::close_fds() {
+  for (auto& [client, _] : this->clients_) {
+    close(client);
+  }
+  this->clients_.clear();
+  if (this->stale_datagrams_ > 0) {
+    LOG_INFO("Dropped %lu stale datagrams", this->stale_datagrams_);
+  }
+  if (this->full_waits_ > 0) {
+    LOG_INFO("Waited for the main thread %lu times since the input event "
+             "queue was full",
+        this->full_waits_);
+  }
+  if (this->socket_ != -1 && !this->unix_path_.empty()) {
+    unlink(this->unix_path_.c_str());
+  }
+  for (int* fd : {&this->wake_fd_, &this->epoll_fd_, &this->socket_}) {
+    if (*fd != -1 && close(*fd) == -1) {
+      LOG_WARN("Failed to close socket properly: %s", std::strerror(errno));
+    }
+    *fd = -1;
   }
 }
 
-void InputListenServer::handle_events(int client) const {
-  constexpr uint32_t kMagic = ('y' << 24) | ('a' << 16) | ('z' << 8) | 'a';
-  std::array<uint8_t, 512> buf{0};
+void InputListenServer::notify_events() {
+  if (!this->has_new_events_) {
+    return;
+  }
+  this->has_new_events_ = false;
+  uint64_t one          = 1;
+  if (write(this->notify_fd_, &one, sizeof(one)) == -1 && errno != EAGAIN) {
+    LOG_WARN("Failed to notify input events: %s", std::strerror(errno));
+  }
+}
+
+int InputListenServer::dispatch_events(
+    int fd, uint32_t /*mask*/, void* data) {
+  auto*    self  = static_cast<InputListenServer*>(data);
+  uint64_t count = 0;
+  if (read(fd, &count, sizeof(count)) == -1 && errno != EAGAIN) {
+    LOG_WARN("Failed to read input eventfd: %s", std::strerror(errno));
+  }
+  // consecutive motion of each ray is resolved in one step so that the seat
+  // notifies clients once per wakeup; other events flush it to keep order
+  std::array<std::array<float, 2>, kMaxRays> motion{};
+  uint32_t                                   moved_rays = 0;  // bit per ray
+
+  auto flush = [&motion, &moved_rays] {
+    for (uint32_t ray = 0; moved_rays != 0; ++ray, moved_rays >>= 1) {
+      if ((moved_rays & 1) == 0) {
+        continue;
+      }
+      Event coalesced{kEventMagic, EventType::MOUSE_MOVE, {}};
+      coalesced.data.movement[0] = motion[ray][0];
+      coalesced.data.movement[1] = motion[ray][1];
+      dispatch(ray, coalesced);
+      motion[ray] = {0.F, 0.F};
+    }
+  };
+
+  uint32_t pings = 0;
+  RayEvent item{};
+  while (self->queue_.pop(item)) {
+    const auto& event = item.event;
+    if (event.type == EventType::PING) {
+      ++pings;  // every Event queued before it has been handled
+      continue;
+    }
+    if (event.type == EventType::MOUSE_MOVE && should_coalesce_motion()) {
+      motion[item.ray][0] += event.data.movement[0];
+      motion[item.ray][1] += event.data.movement[1];
+      moved_rays |= 1U << item.ray;
+      continue;
+    }
+    flush();
+    dispatch(item.ray, event);
+    if (event.type == EventType::MOUSE_MOVE) {
+      // raw motion is picked per event, so the seat sees every step
+      server::get().seat->pick_rays();
+    }
+  }
+  flush();
+  // the queue was drained before the fence, so the input thread either
+  // sees the space or sets the flag before it is read here
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (self->producer_waiting_.exchange(false)) {
+    uint64_t one = 1;
+    if (write(self->space_fd_, &one, sizeof(one)) == -1 && errno != EAGAIN) {
+      LOG_WARN("Failed to wake input thread: %s", std::strerror(errno));
+    }
+  }
+  // every ray moved in this wakeup is resolved in one picking pass
+  server::get().seat->pick_rays();
+  if (pings > 0) {
+    self->handled_pings_.fetch_add(pings);
+    uint64_t one = 1;
+    if (write(self->pong_fd_, &one, sizeof(one)) == -1 && errno != EAGAIN) {
+      LOG_WARN("Failed to wake input thread: %s", std::strerror(errno));
+    }
+  }
+  return 0;
+}
 
-  while (!this->terminate_requested_) {
-    ssize_t size = recv(client, buf.data(), sizeof(uint8_t) * buf.size(), 0);
+bool InputListenServer::handle_events(int client) {
+  auto& decoder = this->clients_[client].decoder;
+  while (true) {
+    auto    buf  = decoder.writable();
+    ssize_t size = recv(client, buf.data(), buf.size(), 0);
     if (size == -1) {
       if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        return true;  // wait for the next epoll_wait
+      }
+      if (errno == EINTR) {
         continue;
       }
       LOG_WARN("Failed to receive data from client: %s", strerror(errno));
-      break;
+      return false;
     }
     if (size == 0) {
       LOG_WARN("Connection is closed (data size was 0)");
-      break;
+      return false;
     }
-    if (size < (ssize_t)sizeof(kMagic)) {
-      continue;
+    decoder.commit(size);
+    this->queue_decoded(decoder, client);
+    if (this->stopping_) {
+      return true;
     }
-    uint32_t received_magic = ((uint32_t)buf[0] << 24) |  //
-                              ((uint32_t)buf[1] << 16) |  //
-                              ((uint32_t)buf[2] << 8) |   //
-                              (uint32_t)buf[3];
-    if (received_magic != kMagic) {
-      LOG_WARN("received an invalid data (magic -> expect: 0x%x, actual: 0x%x)",
-          kMagic, received_magic);
-      continue;
+  }
+}
+
+void InputListenServer::queue_decoded(EventDecoder& decoder, uint64_t origin) {
+  Event event{};
+  while (decoder.next(event)) {
+    if (event.type == EventType::PING) {
+      this->pings_.push_back({origin, event.data.token});
+    }
+    if (!this->push_event(RayEvent{decoder.ray(), event})) {
+      this->stopping_ = true;
+      return;
     }
+  }
+}
 
-    auto* event = (Event*)buf.data();
-    switch (event->type) {
-      case EventType::MOUSE_MOVE:
-        server::get().seat->move_rel_pointing(
-            -event->data.movement[1] / kMouseMovementDivider,
-            -event->data.movement[0] / kMouseMovementDivider);
-        break;
-      case EventType::MOUSE_DOWN:
-        if (event->data.button == BTN_LEFT || event->data.button == BTN_RIGHT) {
-          server::get().seat->handle_mouse_button(
-              event->data.button, WL_POINTER_BUTTON_STATE_PRESSED);
-        }
-        break;
-      case EventType::MOUSE_UP:
-        if (event->data.button == BTN_LEFT || event->data.button == BTN_RIGHT) {
-          server::get().seat->handle_mouse_button(
-              event->data.button, WL_POINTER_BUTTON_STATE_RELEASED);
-        }
-        break;
-      case EventType::MOUSE_WHEEL:
-        server::get().seat->handle_mouse_wheel(event->data.wheel_amount);
-        break;
-      default:
-        LOG_WARN("Unknown event type: %u", static_cast<uint32_t>(event->type));
-        break;
+bool InputListenServer::push_event(const RayEvent& item) {
+  if (this->queue_.push(item)) {
+    this->has_new_events_ = true;
+    return true;
+  }
+  ++this->full_waits_;
+  // the main thread drains the queue when it is woken up
+  this->has_new_events_ = true;
+  this->notify_events();
+  while (true) {
+    this->producer_waiting_.store(true);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    // the main thread may have drained the queue before seeing the flag
+    if (this->queue_.push(item)) {
+      this->producer_waiting_.store(false);
+      this->has_new_events_ = true;
+      return true;
+    }
+    // sockets are not read meanwhile, so senders are throttled by the kernel
+    std::array<pollfd, 2> fds{{
+        {.fd = this->space_fd_, .events = POLLIN, .revents = 0},
+        {.fd = this->wake_fd_, .events = POLLIN, .revents = 0},
+    }};
+    if (poll(fds.data(), fds.size(), -1) == -1) {
+      if (errno == EINTR) {
+        continue;
+      }
+      LOG_ERR("Failed to wait for the input event queue: %s",
+          std::strerror(errno));
+      return false;
+    }
+    if ((fds[1].revents & POLLIN) != 0) {
+      return false;  // wake_fd_ is left readable for epoll_wait
+    }
+    uint64_t count = 0;
+    if (read(this->space_fd_, &count, sizeof(count)) == -1 &&
+        errno != EAGAIN) {
+      LOG_WARN("Failed to read input eventfd: %s", std::strerror(errno));
     }
   }
 }
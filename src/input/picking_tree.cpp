@@ -0,0 +1,211 @@
+#include "input/picking_tree.hpp"
+
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <glm/ext/vector_float3.hpp>
+#include <glm/geometric.hpp>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "input/bounded_object.hpp"
+#include "util/aabb.hpp"
+#include "util/weakable_unique_ptr.hpp"
+
+namespace yaza::input {
+void PickingTree::insert(util::WeakPtr<BoundedObject> obj) {
+  auto* raw = obj.lock();
+  if (raw == nullptr || raw->picking_tree_ != nullptr) {
+    return;
+  }
+  int32_t leaf              = this->allocate();
+  this->nodes_[leaf].obj    = std::move(obj);
+  this->nodes_[leaf].bounds = raw->world_bounds();
+  this->attach(leaf);
+  raw->picking_tree_ = this;
+  raw->picking_leaf_ = leaf;
+}
+
+void PickingTree::update(int32_t leaf, const util::Aabb& bounds) {
+  auto& node = this->nodes_[leaf];
+  if (node.bounds == bounds) {
+    return;
+  }
+  node.bounds = bounds;
+  if (leaf == this->root_) {
+    return;
+  }
+  // reinsert the leaf if it moved out of its sibling's neighborhood so that
+  // the tree stays balanced in space; otherwise only refit its ancestors
+  auto parent  = this->nodes_[leaf].parent;
+  auto sibling = this->nodes_[parent].left == leaf
+                     ? this->nodes_[parent].right
+                     : this->nodes_[parent].left;
+  auto merged  = this->nodes_[sibling].bounds.merged(bounds);
+  if (merged.area() > 2.F * (this->nodes_[sibling].bounds.area() +
+                                bounds.area())) {
+    this->detach(leaf);
+    this->attach(leaf);
+  } else {
+    this->refit(parent);
+  }
+}
+void PickingTree::remove(int32_t leaf) {
+  this->detach(leaf);
+  this->release(leaf);
+}
+
+void PickingTree::raycast(std::span<const Ray> rays, const RayTest& test) {
+  assert(rays.size() <= kMaxRaysPerCast);
+  if (this->root_ == -1 || rays.empty()) {
+    return;
+  }
+  std::array<glm::vec3, kMaxRaysPerCast>            inv_directions;
+  std::array<std::optional<float>, kMaxRaysPerCast> nearest;
+  for (size_t i = 0; i < rays.size(); ++i) {
+    inv_directions[i] = 1.F / glm::normalize(rays[i].direction);
+  }
+
+  const uint32_t all_rays = rays.size() == kMaxRaysPerCast
+                                ? ~0U
+                                : (1U << rays.size()) - 1;
+  auto&          stack    = this->stack_;
+  stack.assign(1, {this->root_, all_rays});
+  while (!stack.empty()) {
+    auto [index, candidates] = stack.back();
+    stack.pop_back();
+    auto&    node    = this->nodes_[index];
+    uint32_t entered = 0;
+    for (; candidates != 0; candidates &= candidates - 1) {
+      auto i     = std::countr_zero(candidates);
+      auto enter = node.bounds.intersect(rays[i].origin, inv_directions[i]);
+      if (enter.has_value() &&
+          (!nearest[i].has_value() || *enter <= *nearest[i])) {
+        entered |= 1U << i;
+      }
+    }
+    if (entered == 0) {
+      continue;
+    }
+    if (node.left != -1) {
+      stack.emplace_back(node.left, entered);
+      stack.emplace_back(node.right, entered);
+      continue;
+    }
+    if (!node.obj.lock()) {
+      continue;
+    }
+    for (; entered != 0; entered &= entered - 1) {
+      auto i        = std::countr_zero(entered);
+      auto distance = test(i, node.obj);
+      if (distance.has_value() &&
+          (!nearest[i].has_value() || *distance < *nearest[i])) {
+        nearest[i] = distance;
+      }
+    }
+  }
+}
+
+int32_t PickingTree::allocate() {
+  if (!this->free_nodes_.empty()) {
+    auto node = this->free_nodes_.back();
+    this->free_nodes_.pop_back();
+    return node;
+  }
+  this->nodes_.emplace_back();
+  return static_cast<int32_t>(this->nodes_.size() - 1);
+}
+void PickingTree::release(int32_t node) {
+  this->nodes_[node] = Node{};
+  this->free_nodes_.push_back(node);
+}
+
+void PickingTree::attach(int32_t leaf) {
+  if (this->root_ == -1) {
+    this->root_               = leaf;
+    this->nodes_[leaf].parent = -1;
+    return;
+  }
+  // choose the sibling by the surface area heuristic, as b2DynamicTree does:
+  // pairing with a node costs the area of the new parent plus the growth of
+  // every ancestor, so the descent stops where going deeper costs more
+  const auto bounds  = this->nodes_[leaf].bounds;
+  int32_t    sibling = this->root_;
+  while (this->nodes_[sibling].left != -1) {
+    const auto& node     = this->nodes_[sibling];
+    const float area     = node.bounds.area();
+    const float combined = node.bounds.merged(bounds).area();
+    // cost of a new parent of `node` and the leaf
+    const float cost = 2.F * combined;
+    // growth inherited by the children if the leaf goes below `node`
+    const float inherited = 2.F * (combined - area);
+    auto        descend   = [this, &bounds, inherited](int32_t child) {
+      const auto& b      = this->nodes_[child].bounds;
+      const float merged = b.merged(bounds).area();
+      if (this->nodes_[child].left == -1) {
+        return merged + inherited;
+      }
+      // a lower bound, since the leaf is paired with a node below `child`
+      return merged - b.area() + inherited;
+    };
+    const float left_cost  = descend(node.left);
+    const float right_cost = descend(node.right);
+    if (cost < left_cost && cost < right_cost) {
+      break;
+    }
+    sibling = left_cost <= right_cost ? node.left : node.right;
+  }
+
+  auto old_parent = this->nodes_[sibling].parent;
+  auto parent     = this->allocate();  // may reallocate `nodes_`
+  this->nodes_[parent].parent  = old_parent;
+  this->nodes_[parent].left    = sibling;
+  this->nodes_[parent].right   = leaf;
+  this->nodes_[sibling].parent = parent;
+  this->nodes_[leaf].parent    = parent;
+  if (old_parent == -1) {
+    this->root_ = parent;
+  } else if (this->nodes_[old_parent].left == sibling) {
+    this->nodes_[old_parent].left = parent;
+  } else {
+    this->nodes_[old_parent].right = parent;
+  }
+  this->refit(parent);
+}
+void PickingTree::detach(int32_t leaf) {
+  if (leaf == this->root_) {
+    this->root_ = -1;
+    return;
+  }
+  auto parent       = this->nodes_[leaf].parent;
+  auto grand_parent = this->nodes_[parent].parent;
+  auto sibling      = this->nodes_[parent].left == leaf
+                          ? this->nodes_[parent].right
+                          : this->nodes_[parent].left;
+  this->nodes_[sibling].parent = grand_parent;
+  if (grand_parent == -1) {
+    this->root_ = sibling;
+  } else {
+    if (this->nodes_[grand_parent].left == parent) {
+      this->nodes_[grand_parent].left = sibling;
+    } else {
+      this->nodes_[grand_parent].right = sibling;
+    }
+    this->refit(grand_parent);
+  }
+  this->release(parent);
+  this->nodes_[leaf].parent = -1;
+}
+void PickingTree::refit(int32_t node) {
+  while (node != -1) {
+    auto& n  = this->nodes_[node];
+    n.bounds = this->nodes_[n.left].bounds.merged(this->nodes_[n.right].bounds);
+    node     = n.parent;
+  }
+}
+}  // namespace yaza::input
@@ -1,8 +1,18 @@
 #include "input/ray_caster.hpp"
 
 #include <GLES3/gl32.h>
+#include <wayland-server-core.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <glm/ext/vector_float2.hpp>
+#include <glm/geometric.hpp>
 
 #include "common.hpp"
+#include "input/ray_predictor.hpp"
 #include "server.hpp"
 
 namespace yaza::input {
@@ -28,9 +38,43 @@ constexpr auto* kFragShader = GLSL(
   }
 );
 // clang-format on
+
+constexpr float kPolarMin = std::numbers::pi / 8.F;
+constexpr float kPolarMax = std::numbers::pi - kPolarMin;
+
+/// set YAZA_PREDICT_RAY=1 to show the ray and the cursor where they are
+/// expected to be at the next session frame
+bool should_predict() {
+  static const bool kEnabled = [] {
+    const char* env = std::getenv("YAZA_PREDICT_RAY");
+    return env != nullptr && std::strcmp(env, "1") == 0;
+  }();
+  return kEnabled;
+}
+
+glm::quat rot_from(const glm::vec2& angles /* polar, azimuthal */) {
+  return glm::angleAxis(angles.y, glm::vec3{0.F, 1.F, 0.F}) *
+         glm::angleAxis((std::numbers::pi_v<float> / 2.F) - angles.x,
+             glm::vec3{-1.F, 0.F, 0.F});
+}
+/// angle between the rays of two poses in degrees
+float degrees_between(const glm::vec2& a, const glm::vec2& b) {
+  const glm::vec3 base(0.F, 0.F, 1.F);
+  const float     cos = glm::dot(
+      glm::rotate(rot_from(a), base), glm::rotate(rot_from(b), base));
+  return std::acos(std::clamp(cos, -1.F, 1.F)) * 180.F /
+         std::numbers::pi_v<float>;
+}
 }  // namespace
 
 RayCaster::RayCaster() {
+  if (should_predict()) {
+    this->predictor_.emplace();
+    this->deadline_timer_ = wl_event_loop_add_timer(
+        server::get().loop(), RayCaster::on_deadline, this);
+  }
+  this->update_ray_rot();
+  this->shown_rot_ = this->rot_;
   if (server::get().remote->has_session()) {
     this->init_ray_renderer();
   }
@@ -44,10 +88,16 @@ RayCaster::RayCaster() {
   this->session_disconnected_listener_.set_handler(
       [this](std::nullptr_t* /*data*/) {
         this->ray_renderer_ = nullptr;
+        this->log_prediction_stats();
       });
   server::get().remote->listen_session_disconnected(
       this->session_disconnected_listener_);
 }
+RayCaster::~RayCaster() {
+  if (this->deadline_timer_ != nullptr) {
+    wl_event_source_remove(this->deadline_timer_);
+  }
+}
 
 glm::vec3 RayCaster::direction() const {
   return glm::rotate(this->rot_, RayCaster::kBaseDirection);
@@ -55,17 +105,28 @@ glm::vec3 RayCaster::direction() const {
 glm::quat RayCaster::rot() const {
   return this->rot_;
 }
+glm::vec3 RayCaster::shown_direction() const {
+  return glm::rotate(this->shown_rot_, RayCaster::kBaseDirection);
+}
 
 float RayCaster::move_rel(float polar, float azimuthal) {
+  const auto now = RayPredictor::Clock::now();
+  // the pose has not changed since the deadline, if it has passed
+  this->score_prediction(now);
+
   this->azimuthal_ += azimuthal;
 
-  constexpr float kPolarMin  = std::numbers::pi / 8.F;
-  constexpr float kPolarMax  = std::numbers::pi - kPolarMin;
-  auto            diff_polar = this->polar_;
-  this->polar_ = std::clamp(this->polar_ + polar, kPolarMin, kPolarMax);
-  diff_polar   = this->polar_ - diff_polar;
+  auto diff_polar = this->polar_;
+  this->polar_    = std::clamp(this->polar_ + polar, kPolarMin, kPolarMax);
+  diff_polar      = this->polar_ - diff_polar;
 
   this->update_ray_rot();
+  if (this->predictor_) {
+    this->predictor_->update({this->polar_, this->azimuthal_}, now);
+    this->predict();
+  } else {
+    this->show({this->polar_, this->azimuthal_});
+  }
   if (this->ray_renderer_) {
     this->ray_renderer_->commit();
   }
@@ -76,6 +137,84 @@ void RayCaster::set_length(std::optional<float> len) {
   this->length_ = len.has_value() ? len.value() : RayCaster::kDefaultRayLen;
 }
 
+void RayCaster::listen_prediction_settled(
+    util::Listener<std::nullptr_t*>& listener) {
+  this->events_.prediction_settled.add_listener(listener);
+}
+float RayCaster::prediction_error() const {
+  const auto& stats = this->prediction_stats_;
+  if (stats.frames == 0) {
+    return 0.F;
+  }
+  return static_cast<float>(
+      stats.predicted_error / static_cast<double>(stats.frames));
+}
+
+void RayCaster::predict() {
+  const auto deadline  = server::get().remote->next_frame();
+  auto       predicted = this->predictor_->predict(deadline);
+  predicted.x          = std::clamp(predicted.x, kPolarMin, kPolarMax);
+  this->pending_prediction_ = Prediction{
+      .deadline  = deadline,
+      .predicted = predicted,
+      .measured  = {this->polar_, this->azimuthal_},
+  };
+  this->show(predicted);
+
+  auto msec = std::chrono::ceil<std::chrono::milliseconds>(
+      deadline - RayPredictor::Clock::now());
+  wl_event_source_timer_update(
+      this->deadline_timer_, std::max(1, static_cast<int>(msec.count())));
+}
+void RayCaster::score_prediction(RayPredictor::Clock::time_point now) {
+  if (!this->pending_prediction_.has_value() ||
+      now < this->pending_prediction_->deadline) {
+    return;
+  }
+  const glm::vec2 actual(this->polar_, this->azimuthal_);
+  const float     error =
+      degrees_between(this->pending_prediction_->predicted, actual);
+  auto& stats = this->prediction_stats_;
+  ++stats.frames;
+  stats.predicted_error += error;
+  stats.measured_error +=
+      degrees_between(this->pending_prediction_->measured, actual);
+  stats.max = std::max(stats.max, error);
+  this->pending_prediction_.reset();
+  if (server::get().remote->has_session()) {
+    server::get().remote->frame_stats().record_prediction_error(error);
+  }
+}
+int RayCaster::on_deadline(void* data) {
+  auto*      self = static_cast<RayCaster*>(data);
+  const auto now  = RayPredictor::Clock::now();
+  self->score_prediction(now);
+  if (self->predictor_->at_rest(now)) {
+    // stop extrapolating a ray which is no longer moved
+    self->predictor_->reset();
+    self->show({self->polar_, self->azimuthal_});
+    self->events_.prediction_settled.emit(nullptr);
+  } else {
+    self->predict();
+  }
+  if (self->ray_renderer_) {
+    self->ray_renderer_->commit();
+  }
+  return 0;
+}
+void RayCaster::log_prediction_stats() {
+  const auto& stats = this->prediction_stats_;
+  if (stats.frames > 0) {
+    auto frames = static_cast<double>(stats.frames);
+    LOG_INFO("RayCaster: %.2f deg prediction error per frame (without "
+             "prediction: %.2f deg, max: %.2f deg, frames: %lu)",
+        static_cast<double>(this->prediction_error()),
+        stats.measured_error / frames,
+        static_cast<double>(stats.max), stats.frames);
+  }
+  this->prediction_stats_ = {};
+}
+
 /*
          +y  -z (head facing direction)
           ^  /
@@ -102,16 +241,17 @@ void RayCaster::init_ray_renderer() {
   this->ray_renderer_->register_buffer(0, 3, GL_FLOAT, vertices.data(),
       sizeof(float) * vertices.size());  // NOLINT
   this->ray_renderer_->request_draw_arrays(GL_LINE_STRIP, 0, 2);
-  this->update_ray_rot();
+  this->show({this->polar_, this->azimuthal_});
   this->ray_renderer_->commit();
 }
 void RayCaster::update_ray_rot() {
-  this->rot_ = glm::angleAxis(this->azimuthal_, glm::vec3{0.F, 1.F, 0.F}) *
-               glm::angleAxis((std::numbers::pi_v<float> / 2.F) - this->polar_,
-                   glm::vec3{-1.F, 0.F, 0.F});
+  this->rot_ = rot_from({this->polar_, this->azimuthal_});
+}
+void RayCaster::show(const glm::vec2& angles) {
+  this->shown_rot_ = rot_from(angles);
   if (this->ray_renderer_) {
     glm::mat4 mat = glm::translate(glm::mat4(1.F), RayCaster::kOrigin) *
-                    glm::toMat4(this->rot_) *
+                    glm::toMat4(this->shown_rot_) *
                     glm::scale(glm::mat4(1.F), glm::vec3(this->length_));
     this->ray_renderer_->set_uniform_matrix(0, "local_model", mat);
   }
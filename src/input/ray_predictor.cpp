@@ -0,0 +1,85 @@
+#include "input/ray_predictor.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <glm/ext/vector_float2.hpp>
+#include <numbers>
+
+namespace yaza::input {
+namespace {
+/// velocity is not updated from samples closer than this
+constexpr auto kMinSampleInterval = std::chrono::milliseconds(1);
+/// the ray is at rest if it is not moved for this
+constexpr auto kRestInterval      = std::chrono::milliseconds(50);
+/// never extrapolate further than this
+constexpr auto kMaxLead           = std::chrono::milliseconds(50);
+
+float smoothing_factor(float cutoff, float dt_sec) {
+  const float tau = 1.F / (2.F * std::numbers::pi_v<float> * cutoff);
+  return 1.F / (1.F + (tau / dt_sec));
+}
+float seconds(std::chrono::steady_clock::duration duration) {
+  return std::chrono::duration<float>(duration).count();
+}
+}  // namespace
+
+float OneEuroFilter::filter(float value, float dt_sec) {
+  if (!this->prev_.has_value() || dt_sec <= 0.F) {
+    this->prev_        = value;
+    this->prev_change_ = 0.F;
+    return value;
+  }
+  const float change = (value - *this->prev_) / dt_sec;
+  const float a_d    = smoothing_factor(this->d_cutoff_, dt_sec);
+  this->prev_change_ = a_d * change + (1.F - a_d) * this->prev_change_;
+
+  const float cutoff =
+      this->min_cutoff_ + this->beta_ * std::abs(this->prev_change_);
+  const float a = smoothing_factor(cutoff, dt_sec);
+  this->prev_   = a * value + (1.F - a) * *this->prev_;
+  return *this->prev_;
+}
+
+void RayPredictor::update(const glm::vec2& angles, Clock::time_point now) {
+  if (this->sample_.has_value() && now - this->time_ > kRestInterval) {
+    // a new movement starts from rest
+    this->reset();
+  }
+  this->angles_ = angles;
+  this->time_   = now;
+
+  if (!this->sample_.has_value()) {
+    this->sample_      = angles;
+    this->sample_time_ = now;
+    return;
+  }
+  const auto interval = now - this->sample_time_;
+  if (interval < kMinSampleInterval) {
+    return;
+  }
+  const float     dt_sec = seconds(interval);
+  const glm::vec2 raw    = (angles - *this->sample_) / dt_sec;
+  this->velocity_.x      = this->polar_velocity_.filter(raw.x, dt_sec);
+  this->velocity_.y      = this->azimuthal_velocity_.filter(raw.y, dt_sec);
+  this->sample_          = angles;
+  this->sample_time_     = now;
+}
+
+glm::vec2 RayPredictor::predict(Clock::time_point deadline) const {
+  auto lead = std::clamp<Clock::duration>(
+      deadline - this->time_, Clock::duration::zero(), kMaxLead);
+  return this->angles_ + this->velocity_ * seconds(lead);
+}
+
+bool RayPredictor::at_rest(Clock::time_point now) const {
+  return !this->sample_.has_value() || now - this->time_ > kRestInterval;
+}
+
+void RayPredictor::reset() {
+  this->polar_velocity_.reset();
+  this->azimuthal_velocity_.reset();
+  this->velocity_ = glm::vec2(0.F);
+  this->sample_.reset();
+}
+}  // namespace yaza::input
@@ -7,7 +7,9 @@
 #include <wayland-server.h>
 #include <wayland-util.h>
 
+#include <array>
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <glm/ext/matrix_float4x4.hpp>
@@ -21,10 +23,12 @@
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtx/quaternion.hpp>
 #include <glm/gtx/string_cast.hpp>
+#include <memory>
 #include <optional>
 
 #include "input/bounded_object.hpp"
 #include "input/input_listen_server.hpp"
+#include "input/picking_tree.hpp"
 #include "input/ray_caster.hpp"
 #include "server.hpp"
 #include "util/weakable_unique_ptr.hpp"
@@ -33,6 +37,13 @@
 #include "zwin/bounded.hpp"
 
 namespace yaza::input {
+static_assert(kMaxRays <= PickingTree::kMaxRaysPerCast);
+
+ServerSeat::ServerSeat() {
+  // the mouse ray is shown from the start
+  this->pointer(0);
+}
+
 bool ServerSeat::is_focused_client(wl_client* client) {
   if (auto* focused_obj = this->keyboard_focused_surface_.lock()) {
     return client == focused_obj->client();
@@ -81,150 +92,246 @@ void ServerSeat::try_leave_keyboard() {
   this->keyboard_focused_surface_.reset();
 }
 
-void ServerSeat::set_surface_as_cursor(
+ServerSeat::Pointer* ServerSeat::pointer(RayId ray) {
+  if (ray >= kMaxRays) {
+    return nullptr;
+  }
+  auto& pointer = this->pointers_[ray];
+  if (!pointer) {
+    pointer = std::make_unique<Pointer>();
+    pointer->prediction_settled_listener.set_handler(
+        [this, ray](std::nullptr_t* /*data*/) {
+          if (this->pointers_[ray]->cursor.lock()) {
+            this->move_cursor(ray);
+          }
+        });
+    pointer->ray.listen_prediction_settled(
+        pointer->prediction_settled_listener);
+  }
+  return pointer.get();
+}
+
+void ServerSeat::set_surface_as_cursor(wl_client* client,
     wl_resource* surface_resource, int32_t hotspot_x, int32_t hotspot_y) {
-  this->hotspot_ =
+  auto it = this->client_seats.find(client);
+  if (it == this->client_seats.end()) {
+    return;
+  }
+  if (auto ray = it->second->pointer_ray()) {
+    this->set_cursor(*ray, surface_resource, hotspot_x, hotspot_y);
+  }
+}
+void ServerSeat::set_cursor(RayId ray, wl_resource* surface_resource,
+    int32_t hotspot_x, int32_t hotspot_y) {
+  auto& pointer = *this->pointer(ray);
+  pointer.hotspot =
       glm::vec3(hotspot_x, -hotspot_y, 0.F) / wayland::surface::kPixelPerMeter;
-  if (this->cursor_.lock()) {
-    if (this->cursor_->resource() == surface_resource) {
+  if (pointer.cursor.lock()) {
+    if (pointer.cursor->resource() == surface_resource) {
       return;
     }
     auto* cursor =
-        dynamic_cast<wayland::surface::Surface*>(this->cursor_.lock());
+        dynamic_cast<wayland::surface::Surface*>(pointer.cursor.lock());
     cursor->set_active(false);
-    this->cursor_.reset();
+    pointer.cursor.reset();
   }
 
   auto surface = server::get().get_surface_from_resource(surface_resource);
   if (surface.has_value()) {
-    this->cursor_ = surface.value();
+    pointer.cursor = surface.value();
     auto* cursor =
-        dynamic_cast<wayland::surface::Surface*>(this->cursor_.lock());
+        dynamic_cast<wayland::surface::Surface*>(pointer.cursor.lock());
     cursor->set_role(wayland::surface::Role::CURSOR, nullptr);
     cursor->set_active(true);
-    this->move_cursor();
+    this->move_cursor(ray);
   }
 }
-void ServerSeat::move_cursor() {
+void ServerSeat::move_cursor(RayId ray) {
+  auto&      pointer   = *this->pointer(ray);
+  const auto direction = pointer.ray.shown_direction();
   const auto pos =
-      (RayCaster::kOrigin + this->cursor_distance_ * this->ray_.direction()) -
-      this->hotspot_;
+      (RayCaster::kOrigin + pointer.cursor_distance * direction) -
+      pointer.hotspot;
   // add rotation to let Surface look at the camera
-  auto rot = this->ray_.rot() * glm::angleAxis(std::numbers::pi_v<float>,
-                                    glm::vec3{0.F, 1.F, 0.F});
-  dynamic_cast<wayland::surface::Surface*>(this->cursor_.lock())
+  auto rot = pointer.ray.shown_rot() * glm::angleAxis(std::numbers::pi_v<float>,
+                                           glm::vec3{0.F, 1.F, 0.F});
+  dynamic_cast<wayland::surface::Surface*>(pointer.cursor.lock())
       ->move(pos, rot);
 }
 
 void ServerSeat::handle_mouse_button(
-    uint32_t button, wl_pointer_button_state state) {
-  if (this->obj_state_ == FocusedObjState::MOVING &&
+    RayId ray, uint32_t button, wl_pointer_button_state state) {
+  auto* pointer = this->pointer(ray);
+  if (pointer == nullptr) {
+    return;
+  }
+  // the focus has to follow motion queued before the button
+  this->pick_rays();
+  if (pointer->obj_state == FocusedObjState::MOVING &&
       state == WL_POINTER_BUTTON_STATE_RELEASED) {
-    this->obj_state_ = FocusedObjState::DEFAULT;
-    this->focused_obj_.reset();
-    check_intersection();
+    pointer->obj_state = FocusedObjState::DEFAULT;
+    pointer->focused_obj.reset();
+    pointer->needs_picking = true;
+    this->pick_rays();
     return;
   }
 
-  if (auto* obj = this->focused_obj_.lock()) {
-    obj->button(button, state);
-    obj->frame();
+  if (auto* obj = pointer->focused_obj.lock()) {
+    obj->button(ray, button, state);
+    obj->frame(ray);
   } else if (state == WL_POINTER_BUTTON_STATE_PRESSED) {
     this->try_leave_keyboard();
   }
 }
-void ServerSeat::handle_mouse_wheel(float amount) {
-  if (auto* obj = this->focused_obj_.lock()) {
-    obj->axis(amount);
-    obj->frame();
+void ServerSeat::handle_mouse_wheel(RayId ray, float amount) {
+  auto* pointer = this->pointer(ray);
+  if (pointer == nullptr) {
+    return;
+  }
+  this->pick_rays();
+  if (auto* obj = pointer->focused_obj.lock()) {
+    obj->axis(ray, amount);
+    obj->frame(ray);
   }
 }
 
 void ServerSeat::request_start_move(wl_client* client) {
-  auto* obj = this->focused_obj_.lock();
-  if (!obj) {
-    return;
-  }
-  if (obj->client() != client) {
+  // the first ray pointing at the client moves its object
+  for (RayId ray = 0; ray < kMaxRays; ++ray) {
+    auto& pointer = this->pointers_[ray];
+    if (!pointer) {
+      continue;
+    }
+    auto* obj = pointer->focused_obj.lock();
+    if (!obj || obj->client() != client) {
+      continue;
+    }
+    obj->leave(ray);
+    obj->frame(ray);
+    pointer->obj_state = FocusedObjState::MOVING;
     return;
   }
-  obj->leave();
-  obj->frame();
-  this->obj_state_ = FocusedObjState::MOVING;
 }
 
-void ServerSeat::move_rel_pointing(float polar, float azimuthal) {
-  const float diff_polar = this->ray_.move_rel(polar, azimuthal);
-  switch (this->obj_state_) {
+void ServerSeat::move_rel_pointing(RayId ray, float polar, float azimuthal) {
+  auto* pointer = this->pointer(ray);
+  if (pointer == nullptr) {
+    return;
+  }
+  const float diff_polar = pointer->ray.move_rel(polar, azimuthal);
+  switch (pointer->obj_state) {
     case FocusedObjState::DEFAULT:
-      this->check_intersection();
+      pointer->needs_picking = true;
       break;
     case FocusedObjState::MOVING:
-      if (auto* obj = this->focused_obj_.lock()) {
+      if (auto* obj = pointer->focused_obj.lock()) {
         obj->move(diff_polar, azimuthal);
       }
+      // the object keeps its distance, so the cursor does too
+      if (pointer->cursor.lock()) {
+        this->move_cursor(ray);
+      }
       break;
   }
-
-  if (this->cursor_.lock()) {
-    this->move_cursor();
-  }
 }
-void ServerSeat::check_intersection() {
-  util::WeakPtr<BoundedObject> nearest_obj;
-  std::optional<IntersectInfo> nearest_obj_info = std::nullopt;
-
-  auto check = [direction = this->ray_.direction(), &nearest_obj,
-                   &nearest_obj_info](util::WeakPtr<BoundedObject>& obj) {
-    auto result = obj->check_intersection(RayCaster::kOrigin, direction);
-    if (!result.has_value()) {
-      return;
-    }
-    if (!nearest_obj_info.has_value() ||
-        result->distance <= nearest_obj_info->distance) {
-      nearest_obj      = obj;
-      nearest_obj_info = result.value();
+
+void ServerSeat::pick_rays() {
+  std::array<PickingTree::Ray, kMaxRays> rays;
+  std::array<RayId, kMaxRays>            ray_ids;
+  size_t                                 count = 0;
+  for (RayId ray = 0; ray < kMaxRays; ++ray) {
+    auto& pointer = this->pointers_[ray];
+    if (!pointer || !pointer->needs_picking) {
+      continue;
     }
-  };
-  server::get().foreach_surface(check);
-  server::get().foreach_bounded_app(check);
+    pointer->needs_picking = false;
+    rays[count]            = {RayCaster::kOrigin, pointer->ray.direction()};
+    ray_ids[count]         = ray;
+    ++count;
+  }
+  if (count == 0) {
+    return;
+  }
+
+  std::array<util::WeakPtr<BoundedObject>, kMaxRays> nearest_objs;
+  std::array<std::optional<IntersectInfo>, kMaxRays> nearest_obj_infos;
+  server::get().picking_tree().raycast({rays.data(), count},
+      [&rays, &nearest_objs, &nearest_obj_infos](size_t i,
+          util::WeakPtr<BoundedObject>& obj) -> std::optional<float> {
+        auto result =
+            obj->check_intersection(rays[i].origin, rays[i].direction);
+        if (!result.has_value()) {
+          return std::nullopt;
+        }
+        auto& nearest_obj_info = nearest_obj_infos[i];
+        if (!nearest_obj_info.has_value() ||
+            result->distance <= nearest_obj_info->distance) {
+          nearest_objs[i]  = obj;
+          nearest_obj_info = result.value();
+        }
+        return result->distance;
+      });
 
+  for (size_t i = 0; i < count; ++i) {
+    this->resolve(ray_ids[i], nearest_objs[i], nearest_obj_infos[i]);
+  }
+}
+void ServerSeat::resolve(RayId ray, util::WeakPtr<BoundedObject>& nearest_obj,
+    std::optional<IntersectInfo>& nearest_obj_info) {
+  auto& pointer = *this->pointers_[ray];
   if (nearest_obj_info.has_value()) {
-    bool focus_changed = this->set_focused_obj(nearest_obj);
+    bool focus_changed = this->set_focused_obj(ray, nearest_obj);
     if (focus_changed) {
-      this->focused_obj_->enter(nearest_obj_info.value());
+      pointer.focused_obj->enter(ray, nearest_obj_info.value());
     }
-    this->focused_obj_->motion(nearest_obj_info.value());
-    this->focused_obj_->frame();
+    pointer.focused_obj->motion(ray, nearest_obj_info.value());
+    pointer.focused_obj->frame(ray);
     // show the cursor nearer to origin than hit position
-    this->cursor_distance_ = nearest_obj_info->distance * 0.98F;
-    this->ray_.set_length(this->cursor_distance_ * 0.9F);
+    pointer.cursor_distance = nearest_obj_info->distance * 0.98F;
+    pointer.ray.set_length(pointer.cursor_distance * 0.9F);
+    if (pointer.cursor.lock()) {
+      this->move_cursor(ray);
+    }
   } else {
     // there is no intersected obj
-    if (auto* obj = this->focused_obj_.lock()) {
-      obj->leave();
-      obj->frame();
-    }
-    this->focused_obj_.reset();
-    this->set_surface_as_cursor(nullptr, 0, 0);
+    this->set_focused_obj(ray, util::WeakPtr<BoundedObject>());
+    this->set_cursor(ray, nullptr, 0, 0);
   }
 }
 
-bool ServerSeat::set_focused_obj(util::WeakPtr<input::BoundedObject> obj) {
-  if (obj == this->focused_obj_) {
+bool ServerSeat::set_focused_obj(
+    RayId ray, util::WeakPtr<input::BoundedObject> obj) {
+  auto& pointer            = *this->pointers_[ray];
+  auto  release_wl_pointer = [this, &pointer, ray] {
+    if (auto it = this->client_seats.find(pointer.focused_client);
+        it != this->client_seats.end()) {
+      it->second->release_pointer(ray);
+    }
+    pointer.focused_client = nullptr;
+  };
+
+  if (!pointer.focused_obj.lock()) {
+    // the focused object may be destroyed without leaving
+    release_wl_pointer();
+  }
+  if (obj == pointer.focused_obj) {
     return false;
   }
-  if (auto* obj = this->focused_obj_.lock()) {
-    obj->leave();
-    obj->frame();
+  if (auto* focused_obj = pointer.focused_obj.lock()) {
+    focused_obj->leave(ray);
+    focused_obj->frame(ray);
   }
-  if (dynamic_cast<zwin::bounded::BoundedApp*>(obj.lock())) {
-    this->client_seats[obj->client()]->data_device_foreach(
-        [](wl_resource* resource) {
-          wayland::data_device::get(resource)->send_selection();
-        });
+  release_wl_pointer();
+  if (auto* new_obj = obj.lock()) {
+    pointer.focused_client = new_obj->client();
+    if (dynamic_cast<zwin::bounded::BoundedApp*>(new_obj)) {
+      this->client_seats[new_obj->client()]->data_device_foreach(
+          [](wl_resource* resource) {
+            wayland::data_device::get(resource)->send_selection();
+          });
+    }
   }
-  this->focused_obj_.swap(obj);
+  pointer.focused_obj.swap(obj);
   return true;
 }
 
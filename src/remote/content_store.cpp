@@ -0,0 +1,88 @@
+#include "remote/content_store.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include "common.hpp"
+#include "util/data_pool.hpp"
+
+namespace yaza::remote {
+namespace {
+/// payloads remembered to detect duplicates
+constexpr size_t kMaxContents = 1024;
+
+/// set YAZA_CONTENT_STATS=1 to hash uploads and count duplicates
+bool should_track_duplicates() {
+  static const bool kEnabled = [] {
+    const char* env = std::getenv("YAZA_CONTENT_STATS");
+    return env != nullptr && std::strcmp(env, "1") == 0;
+  }();
+  return kEnabled;
+}
+}  // namespace
+
+void ContentStore::record_upload(util::DataPool& data) {
+  const auto size = static_cast<size_t>(data.size());
+  if (!should_track_duplicates()) {
+    this->count_upload(size);
+    return;
+  }
+  this->record_upload(data.digest(), size);
+}
+void ContentStore::record_upload(uint64_t digest, size_t size) {
+  this->count_upload(size);
+  if (!should_track_duplicates()) {
+    return;
+  }
+
+  auto it = this->contents_.find(digest);
+  if (it != this->contents_.end()) {
+    if (it->second.first == size) {
+      // the remote already has the same bytes, but zen-remote has no way to
+      // refer them from another object; count it to see what could be saved
+      ++this->stats_.duplicates;
+      this->stats_.duplicated_bytes += size;
+    }
+    it->second.first = size;
+    this->lru_.splice(this->lru_.begin(), this->lru_, it->second.second);
+    return;
+  }
+  if (this->contents_.size() >= kMaxContents) {
+    this->contents_.erase(this->lru_.back());
+    this->lru_.pop_back();
+  }
+  this->lru_.push_front(digest);
+  this->contents_.emplace(digest, std::make_pair(size, this->lru_.begin()));
+}
+void ContentStore::record_skip(size_t size) {
+  ++this->stats_.skips;
+  this->stats_.skipped_bytes += size;
+}
+
+void ContentStore::count_upload(size_t size) {
+  ++this->stats_.uploads;
+  this->stats_.uploaded_bytes += size;
+}
+
+void ContentStore::reset() {
+  const uint64_t requests = this->stats_.uploads + this->stats_.skips;
+  if (requests > 0) {
+    LOG_INFO(
+        "ContentStore: %lu payloads (%lu bytes) were uploaded, "
+        "%lu re-commits were skipped (hit rate: %.1f%%, %lu bytes saved)",
+        this->stats_.uploads, this->stats_.uploaded_bytes, this->stats_.skips,
+        100.0 * static_cast<double>(this->stats_.skips) /
+            static_cast<double>(requests),
+        this->stats_.skipped_bytes);
+  }
+  if (should_track_duplicates() && this->stats_.uploads > 0) {
+    LOG_INFO("ContentStore: %lu uploads duplicated another object (%lu bytes)",
+        this->stats_.duplicates, this->stats_.duplicated_bytes);
+  }
+  this->contents_.clear();
+  this->lru_.clear();
+  this->stats_ = {};
+}
+}  // namespace yaza::remote
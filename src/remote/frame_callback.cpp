@@ -0,0 +1,235 @@
+#include "remote/frame_callback.hpp"
+
+#include <wayland-server-core.h>
+#include <wayland-server-protocol.h>
+#include <wayland-util.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+
+#include "common.hpp"
+#include "util/time.hpp"
+
+namespace yaza::remote {
+namespace {
+/// weight of the newest sample in the predicted latency
+constexpr float kLatencyAlpha = 0.25F;
+/// commits should arrive at least this long before the next session frame
+constexpr int   kMarginMsec   = 3;
+/// callbacks are done anyway after being held for this number of frames, in
+/// case the remote never releases the uploads
+constexpr uint32_t kMaxHeldFrames = 4;
+
+/// set YAZA_STAGGER_FRAME_CALLBACKS=1 to defer callbacks of clients which
+/// render quickly; every callback is sent on the tick by default
+bool should_stagger() {
+  static const bool kEnabled = [] {
+    const char* env = std::getenv("YAZA_STAGGER_FRAME_CALLBACKS");
+    return env != nullptr && std::strcmp(env, "1") == 0;
+  }();
+  return kEnabled;
+}
+}  // namespace
+
+FrameCallbackList::FrameCallbackList(FrameCallbackRegistry& registry)
+    : registry_(registry), fence_(std::make_shared<UploadFence>()) {
+  wl_list_init(&this->pending_);
+  wl_list_init(&this->current_);
+}
+FrameCallbackList::~FrameCallbackList() {
+  if (this->registry_.uploading_ == this) {
+    this->registry_.uploading_ = nullptr;
+  }
+  if (this->enrolled_) {
+    this->registry_.remove(this);
+  }
+  wl_list_remove(&this->pending_);
+  wl_list_remove(&this->current_);
+}
+
+void FrameCallbackList::queue(wl_resource* callback_resource) {
+  wl_list_insert(this->pending_.prev, wl_resource_get_link(callback_resource));
+}
+void FrameCallbackList::commit() {
+  if (this->done_msec_ >= 0) {
+    // the first commit after done is taken as the client's next frame
+    auto now    = util::now_msec();
+    auto sample = static_cast<float>(now - this->done_msec_);
+    if (this->has_latency_) {
+      this->latency_msec_ += kLatencyAlpha * (sample - this->latency_msec_);
+    } else {
+      this->latency_msec_ = sample;
+      this->has_latency_  = true;
+    }
+    this->registry_.record_commit(now, now - this->done_msec_);
+    this->done_msec_ = -1;
+  }
+  wl_list_insert_list(&this->current_, &this->pending_);
+  wl_list_init(&this->pending_);
+  if (!this->enrolled_ && wl_list_empty(&this->current_) == 0) {
+    this->registry_.enroll(this);
+  }
+}
+void FrameCallbackList::send_done(int64_t now_msec) {
+  wl_resource* callback = nullptr;
+  wl_resource* tmp      = nullptr;
+  wl_resource_for_each_safe(callback, tmp, &this->current_) {
+    wl_callback_send_done(callback, static_cast<uint32_t>(now_msec));
+    wl_resource_destroy(callback);
+  }
+  this->done_msec_   = now_msec;
+  this->held_frames_ = 0;
+}
+
+void FrameCallbackList::sync_fence(uint64_t epoch) {
+  if (this->fence_->epoch != epoch) {
+    // the uploads were lost with the previous session
+    this->fence_->in_flight = 0;
+    this->fence_->epoch     = epoch;
+  }
+}
+uint32_t FrameCallbackList::uploads_in_flight(uint64_t epoch) {
+  this->sync_fence(epoch);
+  return this->fence_->in_flight;
+}
+
+UploadScope::UploadScope(FrameCallbackList& list)
+    : registry_(list.registry_), prev_(list.registry_.uploading_) {
+  this->registry_.uploading_ = &list;
+}
+UploadScope::~UploadScope() {
+  this->registry_.uploading_ = this->prev_;
+}
+
+FrameCallbackRegistry::FrameCallbackRegistry(wl_event_loop* loop) {
+  this->timer_source_ = wl_event_loop_add_timer(
+      loop,
+      [](void* data) {
+        static_cast<FrameCallbackRegistry*>(data)->send_deferred(false);
+        return 0;
+      },
+      this);
+}
+FrameCallbackRegistry::~FrameCallbackRegistry() {
+  wl_event_source_remove(this->timer_source_);
+}
+
+void FrameCallbackRegistry::send_done(int budget_msec) {
+  // callbacks deferred in the previous frame must not be late for this one
+  this->send_deferred(true);
+  auto now_msec          = util::now_msec();
+  this->next_frame_msec_ = now_msec + budget_msec;
+  if (this->lists_.empty()) {
+    return;
+  }
+  this->firing_.swap(this->lists_);
+  for (auto* list : this->firing_) {
+    if (list->uploads_in_flight(this->upload_epoch_) > 0) {
+      if (list->held_frames_ < kMaxHeldFrames) {
+        // the previous content has not reached the remote yet
+        ++list->held_frames_;
+        this->lists_.push_back(list);
+        ++this->stats_.held;
+        continue;
+      }
+      ++this->stats_.timed_out;
+    }
+    if (should_stagger() && list->has_latency_) {
+      auto delay = budget_msec - kMarginMsec -
+                   static_cast<int>(list->latency_msec_ + 0.5F);
+      if (delay > 0) {
+        this->deferred_.push_back({list, now_msec + delay});
+        ++this->stats_.staggered;
+        continue;
+      }
+    }
+    list->enrolled_ = false;
+    list->send_done(now_msec);
+  }
+  this->firing_.clear();
+  this->send_deferred(false);
+}
+void FrameCallbackRegistry::send_deferred(bool all) {
+  if (this->deferred_.empty()) {
+    return;
+  }
+  auto now_msec = util::now_msec();
+  auto due      = [all, now_msec](const Deferred& d) {
+    return all || d.due_msec <= now_msec;
+  };
+  for (auto& d : this->deferred_) {
+    if (due(d)) {
+      d.list->enrolled_ = false;
+      d.list->send_done(now_msec);
+    }
+  }
+  std::erase_if(this->deferred_, due);
+
+  int64_t next = -1;
+  for (auto& d : this->deferred_) {
+    if (next < 0 || d.due_msec < next) {
+      next = d.due_msec;
+    }
+  }
+  // 0 disarms the timer
+  wl_event_source_timer_update(this->timer_source_,
+      next < 0 ? 0 : std::max(1, static_cast<int>(next - now_msec)));
+}
+
+void FrameCallbackRegistry::log_stats() {
+  if (this->stats_.commits > 0) {
+    auto commits = static_cast<double>(this->stats_.commits);
+    auto render  = static_cast<double>(this->stats_.render_msec) / commits;
+    auto waiting = static_cast<double>(this->stats_.waiting_msec) / commits;
+    LOG_INFO(
+        "FrameCallbackRegistry: %.1f ms per frame (render: %.1f ms, waiting: "
+        "%.1f ms, commits: %lu, staggered: %lu, held: %lu, timed out: %lu)",
+        render + waiting, render, waiting, this->stats_.commits,
+        this->stats_.staggered, this->stats_.held, this->stats_.timed_out);
+  }
+  this->stats_ = {};
+}
+
+std::function<void()> FrameCallbackRegistry::begin_upload() {
+  if (this->uploading_ == nullptr) {
+    return {};
+  }
+  auto epoch = this->upload_epoch_;
+  this->uploading_->sync_fence(epoch);
+  auto fence = this->uploading_->fence_;
+  ++fence->in_flight;
+  // released on the wayland event loop, so no synchronization is needed
+  return [fence = std::move(fence), epoch]() {
+    if (fence->epoch == epoch && fence->in_flight > 0) {
+      --fence->in_flight;
+    }
+  };
+}
+
+void FrameCallbackRegistry::enroll(FrameCallbackList* list) {
+  list->enrolled_ = true;
+  this->lists_.push_back(list);
+}
+void FrameCallbackRegistry::remove(FrameCallbackList* list) {
+  auto it = std::find(this->lists_.begin(), this->lists_.end(), list);
+  if (it != this->lists_.end()) {
+    *it = this->lists_.back();
+    this->lists_.pop_back();
+    return;
+  }
+  std::erase_if(this->deferred_,
+      [list](const Deferred& d) { return d.list == list; });
+}
+void FrameCallbackRegistry::record_commit(
+    int64_t now_msec, int64_t render_msec) {
+  ++this->stats_.commits;
+  this->stats_.render_msec += render_msec;
+  if (this->next_frame_msec_ > now_msec) {
+    this->stats_.waiting_msec += this->next_frame_msec_ - now_msec;
+  }
+}
+}  // namespace yaza::remote
@@ -0,0 +1,45 @@
+#include "remote/frame_stats.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+#include "common.hpp"
+
+namespace yaza::remote {
+void FrameStats::end_frame() {
+  this->last_frame_ = this->scene_;
+  ++this->stats_.frames;
+  this->stats_.state_changes += this->scene_;
+  this->stats_.max = std::max(this->stats_.max, this->scene_);
+}
+
+void FrameStats::record_prediction_error(float degrees) {
+  ++this->prediction_.frames;
+  this->prediction_.error += degrees;
+}
+float FrameStats::prediction_error() const {
+  if (this->prediction_.frames == 0) {
+    return 0.F;
+  }
+  return static_cast<float>(
+      this->prediction_.error / static_cast<double>(this->prediction_.frames));
+}
+
+void FrameStats::reset() {
+  if (this->stats_.frames > 0) {
+    LOG_INFO("FrameStats: %.1f state changes per frame (max: %u, frames: %lu)",
+        static_cast<double>(this->stats_.state_changes) /
+            static_cast<double>(this->stats_.frames),
+        this->stats_.max, this->stats_.frames);
+  }
+  if (this->prediction_.frames > 0) {
+    LOG_INFO("FrameStats: %.2f deg ray prediction error (frames: %lu)",
+        static_cast<double>(this->prediction_error()),
+        this->prediction_.frames);
+  }
+  this->scene_      = 0;
+  this->last_frame_ = 0;
+  this->stats_      = {};
+  this->prediction_ = {};
+}
+}  // namespace yaza::remote
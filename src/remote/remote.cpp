@@ -52,7 +52,8 @@ Remote::Remote(wl_event_loop* loop)
     : wl_loop_(loop)
     , current_session_(std::nullopt)
     , peer_manager_(zen::remote::server::CreatePeerManager(
-          std::make_unique<Loop>(loop))) {
+          std::make_unique<Loop>(loop)))
+    , frame_callbacks_(loop) {
   if (!logger_initialized) {
     zen::remote::InitializeLogger(std::make_unique<LogSink>());
     logger_initialized = true;
@@ -82,6 +83,9 @@ Remote::Remote(wl_event_loop* loop)
           return;
         }
         LOG_DEBUG("session is established with peer id=%lu", peer_id);
+        // create known shaders and samplers before clients sync their objects
+        this->shader_cache_.warm_up(this->channel_nonnull());
+        this->sampler_cache_.warm_up(this->channel_nonnull());
         this->events_.session_established.emit(this->current_session_->get());
       });
 
@@ -96,16 +100,8 @@ Remote::Remote(wl_event_loop* loop)
       [](void* data) {
         auto* self = static_cast<Remote*>(data);
 
-        if (!self->has_session() ||
-            self->channel_nonnull()->GetBusyness() < kBusynessThreshold) {
-          self->events_.session_frame.emit(nullptr);
-        }
-
-        auto now  = std::chrono::steady_clock::now();
-        auto next = self->prev_frame_;
-        do {
-          next += std::chrono::nanoseconds(kRefreshIntervalNsec);
-        } while (now > next);
+        auto now           = std::chrono::steady_clock::now();
+        auto next          = self->next_frame(now);
         auto duration_nsec = next - now;
         int  duration_msec =
             static_cast<int>(duration_nsec.count()) / kNsecPerMsec;
@@ -113,6 +109,14 @@ Remote::Remote(wl_event_loop* loop)
           duration_msec = 1;
         }
 
+        if (!self->has_session() ||
+            self->channel_nonnull()->GetBusyness() < kBusynessThreshold) {
+          self->frame_callbacks_.send_done(duration_msec);
+          if (self->has_session()) {
+            self->frame_stats_.end_frame();
+          }
+        }
+
         wl_event_source_timer_update(self->frame_timer_source_, duration_msec);
         self->prev_frame_ = next;
         return 0;
@@ -122,12 +126,26 @@ Remote::Remote(wl_event_loop* loop)
       this->frame_timer_source_, (kRefreshIntervalNsec / kNsecPerMsec) + 1);
   this->prev_frame_ = std::chrono::steady_clock::now();
 }
+std::chrono::steady_clock::time_point Remote::next_frame() const {
+  return this->next_frame(std::chrono::steady_clock::now());
+}
+std::chrono::steady_clock::time_point Remote::next_frame(
+    std::chrono::steady_clock::time_point now) const {
+  auto next = this->prev_frame_;
+  do {
+    next += std::chrono::nanoseconds(kRefreshIntervalNsec);
+  } while (now > next);
+  return next;
+}
 Remote::~Remote() {
   LOG_DEBUG("destroying Remote");
   this->peer_discover_signal_disconnector_->Disconnect();
   this->peer_lost_signal_disconnector_->Disconnect();
   if (this->has_session()) {
     this->disconnect();
+  } else {
+    // frame callbacks are paced without a session as well
+    this->frame_callbacks_.log_stats();
   }
   wl_event_source_remove(this->frame_timer_source_);
 }
@@ -145,14 +163,17 @@ void Remote::listen_session_disconnected(
     util::Listener<std::nullptr_t*>& listener) {
   this->events_.session_disconnected.add_listener(listener);
 }
-void Remote::listen_session_frame(util::Listener<std::nullptr_t*>& listener) {
-  this->events_.session_frame.add_listener(listener);
-}
 void Remote::disconnect() {
   assert(this->has_session());
   LOG_DEBUG(
       "disconnecting session (id=%lu)", this->current_session_->get()->id());
   this->current_session_ = std::nullopt;
+  this->content_store_.reset();
+  this->shader_cache_.reset_proxies();
+  this->sampler_cache_.reset_proxies();
+  this->frame_stats_.reset();
+  this->frame_callbacks_.log_stats();
+  this->frame_callbacks_.forget_uploads();
   this->events_.session_disconnected.emit(nullptr);
 }
 }  // namespace yaza::remote
@@ -0,0 +1,140 @@
+#include "remote/sampler_cache.hpp"
+
+#include <zen-remote/server/channel.h>
+#include <zen-remote/server/gl-sampler.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <variant>
+
+#include "common.hpp"
+#include "util/hash.hpp"
+
+namespace yaza::remote {
+namespace {
+/// entries that are not used by anyone are kept up to this number
+constexpr size_t kMaxCachedEntries = 64;
+}  // namespace
+
+bool SamplerParams::merge(const SamplerParams& other) {
+  bool changed = false;
+  for (size_t i = 0; i < this->params_.size(); ++i) {
+    auto& param = other.params_.at(i);
+    if (param.has_value() && this->params_.at(i) != param) {
+      this->params_.at(i) = param;
+      changed             = true;
+    }
+  }
+  return changed;
+}
+bool SamplerParams::empty() const {
+  for (const auto& param : this->params_) {
+    if (param.has_value()) {
+      return false;
+    }
+  }
+  return true;
+}
+uint64_t SamplerParams::hash() const {
+  uint64_t hash = 0;
+  for (const auto& param : this->params_) {
+    if (!param.has_value()) {
+      hash = util::hash_bytes(&hash, sizeof(hash));
+      continue;
+    }
+    hash = util::hash_bytes(&param->type, sizeof(param->type), hash);
+    hash = std::visit(
+        [hash](auto& value) {
+          return util::hash_bytes(&value, sizeof(value), hash);
+        },
+        param->value);
+  }
+  return hash;
+}
+void SamplerParams::send(zen::remote::server::IGlSampler* proxy) const {
+  for (const auto& param : this->params_) {
+    if (!param.has_value()) {
+      continue;
+    }
+    const auto pname = param->pname;
+    // NOLINTBEGIN(google-readability-casting)
+    switch (param->type) {
+      case SamplerParamType::F:
+        proxy->GlSamplerParameterf(pname, std::get<float>(param->value));
+        break;
+      case SamplerParamType::I:
+        proxy->GlSamplerParameteri(pname, std::get<int32_t>(param->value));
+        break;
+      case SamplerParamType::FV: {
+        auto value = std::get<std::array<uint8_t, 16>>(param->value);
+        proxy->GlSamplerParameterfv(pname, (float*)value.data());
+        break;
+      }
+      case SamplerParamType::IV: {
+        auto value = std::get<std::array<uint8_t, 16>>(param->value);
+        proxy->GlSamplerParameteriv(pname, (int32_t*)value.data());
+        break;
+      }
+      case SamplerParamType::IIV: {
+        auto value = std::get<std::array<uint8_t, 16>>(param->value);
+        proxy->GlSamplerParameterIiv(pname, (int32_t*)value.data());
+        break;
+      }
+      case SamplerParamType::IUIV: {
+        auto value = std::get<std::array<uint8_t, 16>>(param->value);
+        proxy->GlSamplerParameterIuiv(pname, (uint32_t*)value.data());
+        break;
+      }
+    }
+    // NOLINTEND(google-readability-casting)
+  }
+}
+
+void CachedSampler::sync(
+    const std::shared_ptr<zen::remote::server::IChannel>& channel) {
+  if (this->proxy.has_value()) {
+    return;
+  }
+  this->proxy = zen::remote::server::CreateGlSampler(channel);
+  this->params.send(this->proxy->get());
+}
+
+std::shared_ptr<CachedSampler> SamplerCache::get(const SamplerParams& params) {
+  uint64_t key      = params.hash();
+  auto [begin, end] = this->samplers_.equal_range(key);
+  for (auto it = begin; it != end; ++it) {
+    if (it->second->params == params) {
+      return it->second;
+    }
+  }
+
+  this->evict();
+  auto sampler = std::make_shared<CachedSampler>(key, params);
+  this->samplers_.emplace(key, sampler);
+  return sampler;
+}
+
+void SamplerCache::warm_up(
+    const std::shared_ptr<zen::remote::server::IChannel>& channel) {
+  for (auto& [key, sampler] : this->samplers_) {
+    sampler->sync(channel);
+  }
+}
+
+void SamplerCache::reset_proxies() {
+  for (auto& [key, sampler] : this->samplers_) {
+    sampler->proxy = std::nullopt;
+  }
+}
+
+void SamplerCache::evict() {
+  if (this->samplers_.size() < kMaxCachedEntries) {
+    return;
+  }
+  std::erase_if(this->samplers_, [](auto& entry) {
+    return entry.second.use_count() == 1;
+  });
+}
+}  // namespace yaza::remote
@@ -0,0 +1,195 @@
+#include "remote/shader_cache.hpp"
+
+#include <zen-remote/server/channel.h>
+#include <zen-remote/server/gl-program.h>
+#include <zen-remote/server/gl-shader.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "common.hpp"
+#include "server.hpp"
+#include "util/hash.hpp"
+
+namespace yaza::remote {
+namespace {
+/// entries that are not used by anyone are kept up to this number
+constexpr size_t kMaxCachedEntries = 128;
+
+bool is_space(char c) {
+  return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+uint64_t combine(uint64_t seed, uint64_t value) {
+  return util::hash_bytes(&value, sizeof(value), seed);
+}
+}  // namespace
+
+void CachedShader::sync(
+    const std::shared_ptr<zen::remote::server::IChannel>& channel) {
+  if (this->proxy.has_value()) {
+    return;
+  }
+  this->proxy =
+      zen::remote::server::CreateGlShader(channel, this->source, this->type);
+  server::get().remote->content_store().record_upload(
+      this->key, this->source.size());
+}
+
+void CachedProgram::sync(
+    const std::shared_ptr<zen::remote::server::IChannel>& channel) {
+  if (this->proxy.has_value()) {
+    return;
+  }
+  this->proxy = zen::remote::server::CreateGlProgram(channel);
+  for (auto& shader : this->shaders) {
+    shader->sync(channel);
+    this->proxy->get()->GlAttachShader(shader->remote_id());
+  }
+  this->proxy->get()->GlLinkProgram();
+}
+
+std::shared_ptr<CachedShader> ShaderCache::get_shader(
+    const char* source, size_t size, uint32_t type) {
+  auto     canonicalized = canonicalize(source, size);
+  uint64_t key           = combine(
+      util::hash_bytes(canonicalized.data(), canonicalized.size()), type);
+
+  auto [begin, end] = this->shaders_.equal_range(key);
+  for (auto it = begin; it != end; ++it) {
+    if (it->second->type == type && it->second->canonical == canonicalized) {
+      // without a session, nothing would have been transferred anyway
+      if (server::get().remote->has_session()) {
+        server::get().remote->content_store().record_skip(size);
+      }
+      return it->second;
+    }
+  }
+
+  this->evict();
+  auto shader = std::make_shared<CachedShader>(
+      key, type, std::move(canonicalized), std::string(source, size));
+  this->shaders_.emplace(key, shader);
+  return shader;
+}
+
+std::shared_ptr<CachedProgram> ShaderCache::get_program(
+    std::vector<std::shared_ptr<CachedShader>>&& shaders) {
+  uint64_t key = 0;
+  for (auto& shader : shaders) {
+    key = combine(key, shader->key);
+  }
+
+  auto [begin, end] = this->programs_.equal_range(key);
+  for (auto it = begin; it != end; ++it) {
+    if (it->second->shaders == shaders) {
+      return it->second;
+    }
+  }
+
+  this->evict();
+  auto program = std::make_shared<CachedProgram>(key, std::move(shaders));
+  this->programs_.emplace(key, program);
+  return program;
+}
+
+void ShaderCache::warm_up(
+    const std::shared_ptr<zen::remote::server::IChannel>& channel) {
+  // references held by cached programs do not keep a shader alive
+  std::unordered_map<const CachedShader*, long> cached_refs;
+  for (auto& [key, program] : this->programs_) {
+    for (auto& shader : program->shaders) {
+      ++cached_refs[shader.get()];
+    }
+  }
+
+  size_t programs = 0;
+  for (auto& [key, program] : this->programs_) {
+    if (program.use_count() > 1) {
+      program->sync(channel);  // creates its shaders as well
+      ++programs;
+    }
+  }
+  size_t shaders = 0;
+  for (auto& [key, shader] : this->shaders_) {
+    if (shader.use_count() > 1 + cached_refs[shader.get()]) {
+      shader->sync(channel);
+    }
+    shaders += shader->proxy.has_value() ? 1 : 0;
+  }
+  LOG_DEBUG("ShaderCache: %lu shaders and %lu programs are created", shaders,
+      programs);
+}
+
+void ShaderCache::reset_proxies() {
+  for (auto& [key, program] : this->programs_) {
+    program->proxy = std::nullopt;
+  }
+  for (auto& [key, shader] : this->shaders_) {
+    shader->proxy = std::nullopt;
+  }
+}
+
+std::string ShaderCache::canonicalize(const char* source, size_t size) {
+  std::string result;
+  result.reserve(size);
+  bool pending_space = false;  // whitespaces are found after the last token
+  for (size_t i = 0; i < size; ++i) {
+    // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    char c    = source[i];
+    char next = i + 1 < size ? source[i + 1] : '\0';
+    // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+    if (c == '/' && next == '/') {
+      while (i < size && source[i] != '\n') {  // NOLINT
+        ++i;
+      }
+      c = '\n';
+    } else if (c == '/' && next == '*') {
+      i += 2;
+      while (i + 1 < size && !(source[i] == '*' && source[i + 1] == '/')) {
+        ++i;  // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+      }
+      ++i;
+      pending_space = true;  // a comment is replaced by a space
+      continue;
+    }
+
+    if (c == '\n') {
+      // newlines are kept since preprocessor directives are line-oriented
+      if (!result.empty() && result.back() != '\n') {
+        result.push_back('\n');
+      }
+      pending_space = false;
+    } else if (is_space(c)) {
+      pending_space = true;
+    } else {
+      if (pending_space && !result.empty() && result.back() != '\n') {
+        result.push_back(' ');
+      }
+      pending_space = false;
+      result.push_back(c);
+    }
+  }
+  if (!result.empty() && result.back() != '\n') {
+    result.push_back('\n');
+  }
+  return result;
+}
+
+void ShaderCache::evict() {
+  if (this->shaders_.size() + this->programs_.size() < kMaxCachedEntries) {
+    return;
+  }
+  // programs first, since they hold references to shaders
+  std::erase_if(this->programs_, [](auto& entry) {
+    return entry.second.use_count() == 1;
+  });
+  std::erase_if(this->shaders_, [](auto& entry) {
+    return entry.second.use_count() == 1;
+  });
+}
+}  // namespace yaza::remote
@@ -8,6 +8,7 @@
 #include <zen-remote/server/gl-vertex-array.h>
 
 #include <glm/ext/quaternion_float.hpp>
+#include <cstring>
 #include <glm/gtc/type_ptr.hpp>
 #include <memory>
 
@@ -36,20 +37,31 @@ Renderer::Renderer(const char* vert_shader, const char* frag_shader)
       channel, this->virtual_object_->id());
   this->technique_ = zen::remote::server::CreateGlBaseTechnique(
       channel, this->rendering_unit_->id());
-  this->vert_shader_ = zen::remote::server::CreateGlShader(
-      channel, vert_shader, GL_VERTEX_SHADER);
-  this->frag_shader_ = zen::remote::server::CreateGlShader(
-      channel, frag_shader, GL_FRAGMENT_SHADER);
-  this->program_    = zen::remote::server::CreateGlProgram(channel);
   this->vert_array_ = zen::remote::server::CreateGlVertexArray(channel);
   this->texture_    = zen::remote::server::CreateGlTexture(channel);
-  this->sampler_    = zen::remote::server::CreateGlSampler(channel);
 
-  this->program_->GlAttachShader(this->vert_shader_->id());
-  this->program_->GlAttachShader(this->frag_shader_->id());
-  this->program_->GlLinkProgram();
+  // every Renderer with the same sources shares one remote program
+  auto& cache    = server::get().remote->shader_cache();
+  this->program_ = cache.get_program({
+      cache.get_shader(vert_shader, std::strlen(vert_shader), GL_VERTEX_SHADER),
+      cache.get_shader(
+          frag_shader, std::strlen(frag_shader), GL_FRAGMENT_SHADER),
+  });
+  this->program_->sync(channel);
 
-  this->technique_->BindProgram(this->program_->id());
+  remote::SamplerParams params;
+  for (uint32_t pname : {GL_TEXTURE_MAG_FILTER, GL_TEXTURE_MIN_FILTER}) {
+    params.set(remote::SamplerParams::index_of(pname).value(),
+        {
+            .type  = remote::SamplerParamType::I,
+            .pname = pname,
+            .value = GL_NEAREST,
+        });
+  }
+  this->sampler_ = server::get().remote->sampler_cache().get(params);
+  this->sampler_->sync(channel);
+
+  this->technique_->BindProgram(this->program_->remote_id());
   this->technique_->BindVertexArray(this->vert_array_->id());
 }
 
@@ -81,10 +93,8 @@ void Renderer::set_texture(
   this->texture_->GlTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0,
       GL_RGBA, GL_UNSIGNED_BYTE, texture.create_buffer());
   this->texture_->GlGenerateMipmap(GL_TEXTURE_2D);
-  this->sampler_->GlSamplerParameteri(GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-  this->sampler_->GlSamplerParameteri(GL_TEXTURE_MIN_FILTER, GL_NEAREST);
   this->technique_->BindTexture(
-      0, "", this->texture_->id(), GL_TEXTURE_2D, this->sampler_->id());
+      0, "", this->texture_->id(), GL_TEXTURE_2D, this->sampler_->remote_id());
 }
 void Renderer::set_uniform_matrix(
     uint32_t location, const char* name, glm::mat4& mat) {
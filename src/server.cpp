@@ -13,6 +13,7 @@
 #include "input/bounded_object.hpp"
 #include "input/server_seat.hpp"
 #include "remote/remote.hpp"
+#include "util/commit_pool.hpp"
 #include "util/weakable_unique_ptr.hpp"
 #include "wayland/surface.hpp"
 #include "wayland/wayland.hpp"
@@ -104,6 +105,7 @@ void Server::terminate() {
   if (this->wl_display_) {
     wl_display_destroy(this->wl_display_);
   }
+  util::log_commit_pool_stats();
 }
 
 void Server::start() {
@@ -122,11 +124,13 @@ wl_event_loop* Server::loop() {
 }
 
 void Server::add_surface(util::WeakPtr<input::BoundedObject>&& surface) {
+  this->picking_tree_.insert(surface);
   this->surfaces_.emplace_front(std::move(surface));
   this->reorder_surfaces();
 }
 void Server::add_bounded_app(
     util::WeakPtr<input::BoundedObject>&& bounded_app) {
+  this->picking_tree_.insert(bounded_app);
   this->bounded_apps_.emplace_front(std::move(bounded_app));
 }
 
@@ -0,0 +1,129 @@
+#include "util/aabb.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <glm/common.hpp>
+#include <glm/ext/matrix_float4x4.hpp>
+#include <glm/ext/vector_float3.hpp>
+#include <glm/geometric.hpp>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace yaza::util {
+namespace {
+/// enough for 2^32 boxes
+constexpr size_t kStackSize = 64;
+}  // namespace
+
+Aabb Aabb::from_obb(const glm::mat4& model_mat, const glm::vec3& half_size) {
+  const glm::vec3 center = model_mat[3];
+  glm::vec3       extent(0.F);
+  for (int i = 0; i <= 2; ++i) {
+    extent += glm::abs(glm::vec3(model_mat[i]) * half_size[i]);
+  }
+  return {.min = center - extent, .max = center + extent};
+}
+
+std::optional<float> Aabb::intersect(
+    const glm::vec3& origin, const glm::vec3& inv_direction) const {
+  // slab method; an infinite inv_direction makes the axis either always or
+  // never overlap, which is handled by min/max
+  const glm::vec3 t0   = (this->min - origin) * inv_direction;
+  const glm::vec3 t1   = (this->max - origin) * inv_direction;
+  const glm::vec3 tmin = glm::min(t0, t1);
+  const glm::vec3 tmax = glm::max(t0, t1);
+  const float     near = std::max({tmin.x, tmin.y, tmin.z, 0.F});
+  const float     far  = std::min({tmax.x, tmax.y, tmax.z});
+  if (near > far || std::isnan(near) || std::isnan(far)) {
+    return std::nullopt;
+  }
+  return near;
+}
+
+void AabbBvh::build(const std::vector<Aabb>& boxes) {
+  this->nodes_.clear();
+  this->indices_.resize(boxes.size());
+  std::iota(this->indices_.begin(), this->indices_.end(), 0);
+  if (boxes.empty()) {
+    return;
+  }
+  this->nodes_.reserve((2 * boxes.size()) - 1);
+  this->nodes_.push_back({.bounds = {},
+      .first                      = 0,
+      .count = static_cast<uint32_t>(boxes.size())});
+  this->split(0, boxes);
+}
+void AabbBvh::split(uint32_t node, const std::vector<Aabb>& boxes) {
+  auto  first = this->nodes_[node].first;
+  auto  count = this->nodes_[node].count;
+  Aabb  bounds;
+  Aabb  centers;
+  auto  begin = this->indices_.begin() + first;
+  auto  end   = begin + count;
+  for (auto it = begin; it != end; ++it) {
+    bounds.merge(boxes[*it]);
+    auto center = (boxes[*it].min + boxes[*it].max) * 0.5F;
+    centers.merge({center, center});
+  }
+  this->nodes_[node].bounds = bounds;
+  if (count <= kMaxLeafSize) {
+    return;
+  }
+
+  // median split along the longest axis of the centers
+  auto extent = centers.max - centers.min;
+  int  axis   = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2)
+                                    : (extent.y > extent.z ? 1 : 2);
+  auto mid    = begin + (count / 2);
+  std::nth_element(begin, mid, end, [&boxes, axis](uint32_t a, uint32_t b) {
+    return boxes[a].min[axis] + boxes[a].max[axis] <
+           boxes[b].min[axis] + boxes[b].max[axis];
+  });
+
+  auto left  = static_cast<uint32_t>(this->nodes_.size());
+  auto half  = static_cast<uint32_t>(mid - begin);
+  this->nodes_.push_back({.bounds = {}, .first = first, .count = half});
+  this->nodes_.push_back(
+      {.bounds = {}, .first = first + half, .count = count - half});
+  this->nodes_[node].first = left;
+  this->nodes_[node].count = 0;
+  this->split(left, boxes);
+  this->split(left + 1, boxes);
+}
+
+std::optional<float> AabbBvh::raycast(const glm::vec3& origin,
+    const glm::vec3& direction, const LeafTest& test) const {
+  if (this->nodes_.empty()) {
+    return std::nullopt;
+  }
+  const glm::vec3 inv_direction = 1.F / glm::normalize(direction);
+  std::optional<float>             nearest;
+  std::array<uint32_t, kStackSize> stack;
+  size_t                           size = 0;
+  stack[size++]                         = 0;
+  while (size > 0) {
+    const auto& node  = this->nodes_[stack[--size]];
+    auto        enter = node.bounds.intersect(origin, inv_direction);
+    if (!enter.has_value() || (nearest.has_value() && *enter > *nearest)) {
+      continue;
+    }
+    if (node.count == 0) {
+      stack[size++] = node.first;
+      stack[size++] = node.first + 1;
+      continue;
+    }
+    auto distance = test(node.first, node.count);
+    if (distance.has_value() &&
+        (!nearest.has_value() || *distance < *nearest)) {
+      nearest = distance;
+    }
+  }
+  return nearest;
+}
+}  // namespace yaza::util
@@ -0,0 +1,35 @@
+#include "util/box.hpp"
+
+#include <glm/ext/matrix_float4x4.hpp>
+#include <glm/gtc/matrix_inverse.hpp>
+#include <glm/gtx/quaternion.hpp>
+
+namespace yaza::util {
+const glm::mat4& Box::mat() const {
+  this->update_cache();
+  return this->mat_;
+}
+const glm::mat4& Box::rigid_mat() const {
+  this->update_cache();
+  return this->rigid_mat_;
+}
+const glm::mat4& Box::inverse_rigid_mat() const {
+  this->update_cache();
+  return this->inverse_rigid_mat_;
+}
+const glm::mat4& Box::rotation_mat() const {
+  this->update_cache();
+  return this->rotation_mat_;
+}
+
+void Box::update_cache() const {
+  if (!this->dirty_) {
+    return;
+  }
+  this->rotation_mat_      = glm::toMat4(this->rot_);
+  this->rigid_mat_         = this->translation_mat() * this->rotation_mat_;
+  this->inverse_rigid_mat_ = glm::affineInverse(this->rigid_mat_);
+  this->mat_               = this->rigid_mat_ * this->scale_mat();
+  this->dirty_             = false;
+}
+}  // namespace yaza::util
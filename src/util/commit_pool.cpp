@@ -0,0 +1,82 @@
+#include "util/commit_pool.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+#include "common.hpp"
+
+namespace yaza::util {
+void* CountingResource::do_allocate(size_t bytes, size_t alignment) {
+  ++this->allocations_;
+  this->allocated_bytes_ += bytes;
+  return this->upstream_->allocate(bytes, alignment);
+}
+void CountingResource::do_deallocate(
+    void* p, size_t bytes, size_t alignment) {
+  this->upstream_->deallocate(p, bytes, alignment);
+}
+bool CountingResource::do_is_equal(
+    const std::pmr::memory_resource& other) const noexcept {
+  return this == &other;
+}
+
+namespace {
+/// requests (from containers) -> pool -> heap
+struct CommitPool {
+  CountingResource                       heap{std::pmr::new_delete_resource()};
+  std::pmr::unsynchronized_pool_resource pool{&this->heap};
+  CountingResource                       requests{&this->pool};
+
+  struct {
+    uint64_t count        = 0;
+    uint64_t requests     = 0;
+    uint64_t heap         = 0;
+    uint64_t max_requests = 0;
+    uint64_t max_heap     = 0;
+  } commits;
+};
+CommitPool& instance() {
+  // never destroyed so that objects can be released during static destruction
+  static auto* pool = new CommitPool();
+  return *pool;
+}
+}  // namespace
+
+std::pmr::memory_resource* commit_pool() {
+  return &instance().requests;
+}
+void log_commit_pool_stats() {
+  auto& pool = instance();
+  LOG_INFO("commit pool: %lu allocations (%lu bytes) were requested, "
+           "%lu allocations (%lu bytes) reached the heap",
+      pool.requests.allocations(), pool.requests.allocated_bytes(),
+      pool.heap.allocations(), pool.heap.allocated_bytes());
+  const auto& commits = pool.commits;
+  if (commits.count == 0) {
+    return;
+  }
+  const auto count = static_cast<double>(commits.count);
+  LOG_INFO("commit pool: %lu commits requested %.1f allocations on average "
+           "(max %lu), %.1f of them reached the heap (max %lu)",
+      commits.count, static_cast<double>(commits.requests) / count,
+      commits.max_requests, static_cast<double>(commits.heap) / count,
+      commits.max_heap);
+}
+
+CommitPoolScope::CommitPoolScope()
+    : requests_(instance().requests.allocations())
+    , heap_(instance().heap.allocations()) {
+}
+CommitPoolScope::~CommitPoolScope() {
+  auto&      pool     = instance();
+  const auto requests = pool.requests.allocations() - this->requests_;
+  const auto heap     = pool.heap.allocations() - this->heap_;
+  ++pool.commits.count;
+  pool.commits.requests += requests;
+  pool.commits.heap += heap;
+  pool.commits.max_requests = std::max(pool.commits.max_requests, requests);
+  pool.commits.max_heap     = std::max(pool.commits.max_heap, heap);
+}
+}  // namespace yaza::util
@@ -3,12 +3,16 @@
 #include <wayland-server-core.h>
 #include <zen-remote/server/buffer.h>
 
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
 #include <memory>
+#include <utility>
 
 #include "remote/loop.hpp"
+#include "remote/remote.hpp"
 #include "server.hpp"
+#include "util/hash.hpp"
 #include "util/weak_resource.hpp"
 
 namespace yaza::util {
@@ -53,15 +57,37 @@ void DataPool::from_ptr(const void* data, ssize_t size) {
 
 std::unique_ptr<zen::remote::server::IBuffer> DataPool::create_buffer() {
   auto data(this->data_);
+  auto on_release = server::get().remote->frame_callbacks().begin_upload();
   return zen::remote::server::CreateBuffer(
       data.get(),
-      [data = std::move(data)]() mutable {
+      [data = std::move(data), on_release = std::move(on_release)]() mutable {
         data.reset();
+        if (on_release) {
+          on_release();
+        }
       },
       std::make_unique<remote::Loop>(server::get().loop()));
 }
+uint64_t DataPool::digest() {
+  if (!this->digest_.has_value()) {
+    this->digest_ = util::hash_bytes(this->data_.get(), this->size_);
+  }
+  return this->digest_.value();
+}
+bool DataPool::same_content(DataPool& other) {
+  if (this->size_ != other.size_) {
+    return false;
+  }
+  if (this->data_ == other.data_) {
+    return true;
+  }
+  return this->digest() == other.digest() &&
+         std::memcmp(this->data_.get(), other.data_.get(), this->size_) == 0;
+}
+
 /// renew `size_` and reallocate `data_` if the capacity is not enough
 void DataPool::ensure_and_set_data_size(ssize_t size) {
+  this->digest_.reset();  // data will be overwritten by the caller
   if (this->size_ >= size) {
     this->size_ = size;
     return;
@@ -0,0 +1,83 @@
+#include "util/hash.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace yaza::util {
+namespace {
+constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t kPrime4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t kPrime5 = 0x27D4EB2F165667C5ULL;
+
+template <typename T>
+T read(const uint8_t* p) {
+  T v;
+  std::memcpy(&v, p, sizeof(T));
+  return v;  // assuming little-endian (x86_64 and aarch64)
+}
+uint64_t round(uint64_t acc, uint64_t input) {
+  acc += input * kPrime2;
+  acc = std::rotl(acc, 31);
+  return acc * kPrime1;
+}
+uint64_t merge_round(uint64_t acc, uint64_t val) {
+  acc ^= round(0, val);
+  return (acc * kPrime1) + kPrime4;
+}
+}  // namespace
+
+// NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+uint64_t hash_bytes(const void* data, size_t size, uint64_t seed) {
+  const auto* p   = static_cast<const uint8_t*>(data);
+  const auto* end = p + size;
+  uint64_t    h   = 0;
+
+  if (size >= 32) {
+    uint64_t v1 = seed + kPrime1 + kPrime2;
+    uint64_t v2 = seed + kPrime2;
+    uint64_t v3 = seed;
+    uint64_t v4 = seed - kPrime1;
+    for (; p + 32 <= end; p += 32) {
+      v1 = round(v1, read<uint64_t>(p));
+      v2 = round(v2, read<uint64_t>(p + 8));
+      v3 = round(v3, read<uint64_t>(p + 16));
+      v4 = round(v4, read<uint64_t>(p + 24));
+    }
+    h = std::rotl(v1, 1) + std::rotl(v2, 7) + std::rotl(v3, 12) +
+        std::rotl(v4, 18);
+    h = merge_round(h, v1);
+    h = merge_round(h, v2);
+    h = merge_round(h, v3);
+    h = merge_round(h, v4);
+  } else {
+    h = seed + kPrime5;
+  }
+  h += size;
+
+  for (; p + 8 <= end; p += 8) {
+    h ^= round(0, read<uint64_t>(p));
+    h = (std::rotl(h, 27) * kPrime1) + kPrime4;
+  }
+  if (p + 4 <= end) {
+    h ^= read<uint32_t>(p) * kPrime1;
+    h = (std::rotl(h, 23) * kPrime2) + kPrime3;
+    p += 4;
+  }
+  for (; p < end; ++p) {
+    h ^= *p * kPrime5;
+    h = std::rotl(h, 11) * kPrime1;
+  }
+
+  h ^= h >> 33;
+  h *= kPrime2;
+  h ^= h >> 29;
+  h *= kPrime3;
+  h ^= h >> 32;
+  return h;
+}
+// NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+}  // namespace yaza::util
@@ -1,6 +1,11 @@
 #include "util/intersection.hpp"
 
 #include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <glm/ext/vector_float3.hpp>
 #include <glm/geometric.hpp>
 #include <glm/gtc/matrix_access.hpp>
@@ -8,8 +13,32 @@
 #include <glm/gtx/vector_query.hpp>
 #include <limits>
 #include <optional>
+#include <vector>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
 
 namespace yaza::util::intersection {
+namespace {
+/// the vector is taken as parallel to a slab below this cosine
+constexpr float  kParallelEpsilon = 0.001F;
+constexpr size_t kBatchWidth     = 8;
+
+#if defined(__x86_64__)
+bool has_avx2() {
+  static const bool kSupported = __builtin_cpu_supports("avx2") != 0;
+  return kSupported;
+}
+#endif
+
+void keep_nearest(std::optional<float>& nearest, std::optional<float> d) {
+  if (d.has_value() && (!nearest.has_value() || *d < *nearest)) {
+    nearest = d;
+  }
+}
+}  // namespace
+
 // using Möller–Trumbore intersection algorithm
 std::optional<SurfaceInfo> with_surface(const glm::vec3& o,
     const glm::vec3& dir, const glm::vec3& v0, const glm::vec3& v1,
@@ -57,7 +86,7 @@ std::optional<float> with_obb(const glm::vec3& origin,
     const glm::vec3 axis = model_mat[i];
     const float     e    = glm::dot(axis, delta);
     const float     f    = glm::dot(direction_norm, axis);
-    if (std::abs(f) > 0.001F) {
+    if (std::abs(f) > kParallelEpsilon) {
       float intersect_min = (e - half_size[i]) / f;
       float intersect_max = (e + half_size[i]) / f;
       if (intersect_min > intersect_max) {
@@ -74,4 +103,139 @@ std::optional<float> with_obb(const glm::vec3& origin,
   }
   return near;
 }
+
+void ObbBatch::clear() {
+  for (int i = 0; i <= 2; ++i) {
+    this->center_[i].clear();
+    this->half_size_[i].clear();
+    for (auto& axis : this->axis_[i]) {
+      axis.clear();
+    }
+  }
+}
+void ObbBatch::push(const glm::mat4& model_mat, const glm::vec3& half_size) {
+  for (int i = 0; i <= 2; ++i) {
+    this->center_[i].push_back(model_mat[3][i]);
+    this->half_size_[i].push_back(half_size[i]);
+    for (int c = 0; c <= 2; ++c) {
+      this->axis_[i][c].push_back(model_mat[i][c]);
+    }
+  }
+}
+
+std::optional<float> ObbBatch::raycast(const glm::vec3& origin,
+    const glm::vec3& direction_norm, size_t first, size_t count) const {
+  std::optional<float> nearest;
+  size_t               i   = first;
+  const size_t         end = first + count;
+#if defined(__x86_64__)
+  if (has_avx2()) {
+    for (; i + kBatchWidth <= end; i += kBatchWidth) {
+      keep_nearest(nearest, this->raycast_avx2(origin, direction_norm, i));
+    }
+  }
+#endif
+  for (; i < end; ++i) {
+    keep_nearest(nearest, this->raycast_one(origin, direction_norm, i));
+  }
+  return nearest;
+}
+
+// same as `with_obb`
+std::optional<float> ObbBatch::raycast_one(const glm::vec3& origin,
+    const glm::vec3& direction_norm, size_t index) const {
+  const glm::vec3 delta = glm::vec3(this->center_[0][index],
+                              this->center_[1][index],
+                              this->center_[2][index]) -
+                          origin;
+
+  float near = 0.F;
+  float far  = std::numeric_limits<float>::max();
+  for (int i = 0; i <= 2; ++i) {
+    const glm::vec3 axis(this->axis_[i][0][index], this->axis_[i][1][index],
+        this->axis_[i][2][index]);
+    const float half_size = this->half_size_[i][index];
+    const float e         = glm::dot(axis, delta);
+    const float f         = glm::dot(direction_norm, axis);
+    if (std::abs(f) > kParallelEpsilon) {
+      float intersect_min = (e - half_size) / f;
+      float intersect_max = (e + half_size) / f;
+      if (intersect_min > intersect_max) {
+        std::swap(intersect_min, intersect_max);
+      }
+      far  = std::min(far, intersect_max);
+      near = std::max(near, intersect_min);
+      if (far < near) {
+        return std::nullopt;
+      }
+    } else if (-e - half_size > 0.F || -e + half_size < 0.F) {
+      return std::nullopt;
+    }
+  }
+  return near;
+}
+
+#if defined(__x86_64__)
+// the slab test of `raycast_one` for 8 boxes; parallel slabs are blended
+// out instead of branching
+__attribute__((target("avx2"))) std::optional<float> ObbBatch::raycast_avx2(
+    const glm::vec3& origin, const glm::vec3& direction_norm,
+    size_t first) const {
+  const __m256 zero      = _mm256_setzero_ps();
+  const __m256 epsilon   = _mm256_set1_ps(kParallelEpsilon);
+  const __m256 sign_mask = _mm256_set1_ps(-0.F);
+
+  // std::array would drop the alignment attribute of __m256
+  __m256 delta[3];  // NOLINT(*-avoid-c-arrays)
+  __m256 dir[3];    // NOLINT(*-avoid-c-arrays)
+  for (int c = 0; c <= 2; ++c) {
+    delta[c] = _mm256_sub_ps(_mm256_loadu_ps(&this->center_[c][first]),
+        _mm256_set1_ps(origin[c]));
+    dir[c]   = _mm256_set1_ps(direction_norm[c]);
+  }
+
+  __m256 near = zero;
+  __m256 far  = _mm256_set1_ps(std::numeric_limits<float>::max());
+  __m256 miss = zero;
+  for (int i = 0; i <= 2; ++i) {
+    __m256 e = zero;
+    __m256 f = zero;
+    for (int c = 0; c <= 2; ++c) {
+      const __m256 axis = _mm256_loadu_ps(&this->axis_[i][c][first]);
+      e = _mm256_add_ps(e, _mm256_mul_ps(axis, delta[c]));
+      f = _mm256_add_ps(f, _mm256_mul_ps(axis, dir[c]));
+    }
+    const __m256 half_size = _mm256_loadu_ps(&this->half_size_[i][first]);
+    const __m256 parallel  = _mm256_cmp_ps(
+        _mm256_andnot_ps(sign_mask, f), epsilon, _CMP_LE_OQ);
+
+    const __m256 t1   = _mm256_div_ps(_mm256_sub_ps(e, half_size), f);
+    const __m256 t2   = _mm256_div_ps(_mm256_add_ps(e, half_size), f);
+    const __m256 tmin = _mm256_min_ps(t1, t2);
+    const __m256 tmax = _mm256_max_ps(t1, t2);
+    near = _mm256_blendv_ps(_mm256_max_ps(near, tmin), near, parallel);
+    far  = _mm256_blendv_ps(_mm256_min_ps(far, tmax), far, parallel);
+
+    const __m256 outside = _mm256_or_ps(
+        _mm256_cmp_ps(e, _mm256_xor_ps(half_size, sign_mask), _CMP_LT_OQ),
+        _mm256_cmp_ps(e, half_size, _CMP_GT_OQ));
+    miss = _mm256_or_ps(miss, _mm256_and_ps(parallel, outside));
+  }
+  const __m256 hit =
+      _mm256_andnot_ps(miss, _mm256_cmp_ps(far, near, _CMP_GE_OQ));
+  auto mask = static_cast<uint32_t>(_mm256_movemask_ps(hit));
+  if (mask == 0) {
+    return std::nullopt;
+  }
+
+  std::array<float, kBatchWidth> distances;
+  _mm256_storeu_ps(distances.data(), near);
+  float nearest = std::numeric_limits<float>::max();
+  while (mask != 0) {
+    nearest = std::min(nearest, distances[std::countr_zero(mask)]);
+    mask &= mask - 1;
+  }
+  return nearest;
+}
+#endif
 }  // namespace yaza::util::intersection
@@ -0,0 +1,20 @@
+#include "util/slot_table.hpp"
+
+#include <cstdint>
+
+namespace yaza::util {
+uint32_t SlotTable::acquire() {
+  if (this->free_indices_.empty()) {
+    this->generations_.push_back(0);
+    return static_cast<uint32_t>(this->generations_.size() - 1);
+  }
+  const uint32_t index = this->free_indices_.back();
+  this->free_indices_.pop_back();
+  return index;
+}
+void SlotTable::release(uint32_t index) {
+  // handles to the old generation will never be alive again
+  ++this->generations_[index];
+  this->free_indices_.push_back(index);
+}
+}  // namespace yaza::util
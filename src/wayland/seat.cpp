@@ -49,7 +49,7 @@ void ClientSeat::add_data_device(wl_resource* resource) {
   wl_list_insert(&this->data_devices_, wl_resource_get_link(resource));
 }
 void ClientSeat::add_ray(wl_resource* resource) {
-  wl_list_insert(&this->rays_, wl_resource_get_link(resource));
+  wl_list_insert(this->rays_.prev, wl_resource_get_link(resource));
 }
 
 void ClientSeat::pointer_foreach(
@@ -81,6 +81,29 @@ void ClientSeat::ray_foreach(
   }
 }
 
+wl_resource* ClientSeat::ray(uint32_t index) const {
+  wl_resource* resource = nullptr;
+  wl_resource_for_each(resource, &this->rays_) {
+    if (index-- == 0) {
+      return resource;
+    }
+  }
+  return nullptr;
+}
+
+bool ClientSeat::acquire_pointer(uint32_t ray) {
+  if (this->pointer_ray_.has_value() && *this->pointer_ray_ != ray) {
+    return false;
+  }
+  this->pointer_ray_ = ray;
+  return true;
+}
+void ClientSeat::release_pointer(uint32_t ray) {
+  if (this->pointer_ray_ == ray) {
+    this->pointer_ray_.reset();
+  }
+}
+
 namespace {
 void get_pointer(wl_client* client, wl_resource* /*resource*/, uint32_t id) {
   pointer::create(client, id);
@@ -26,10 +26,11 @@
 #include "remote/session.hpp"
 #include "renderer.hpp"
 #include "server.hpp"
+#include "util/aabb.hpp"
 #include "util/box.hpp"
 #include "util/intersection.hpp"
+#include "util/overloaded.hpp"
 #include "util/time.hpp"
-#include "util/visitor_list.hpp"
 #include "util/weakable_unique_ptr.hpp"
 #include "xdg_shell/xdg_toplevel.hpp"
 
@@ -67,6 +68,7 @@ constexpr float kLayerZOffset = 0.0001F;
 Surface::Surface(wl_resource* resource)
     : input::BoundedObject(util::Box(
           glm::vec3(0.F, 0.85F, 0.F), glm::quat(), glm::vec3{1.F, 1.F, 0.F}))
+    , frame_callbacks_(server::get().remote->frame_callbacks())
     , resource_(resource) {
   if (server::get().remote->has_session()) {
     this->init_renderer();
@@ -85,30 +87,18 @@ Surface::Surface(wl_resource* resource)
   server::get().remote->listen_session_disconnected(
       this->session_disconnected_listener_);
 
-  wl_list_init(&this->pending_.frame_callback_list);
-  wl_list_init(&this->current_.frame_callback_list);
-  this->session_frame_listener_.set_handler([this](std::nullptr_t* /*data*/) {
-    auto         now_msec = util::now_msec();
-    wl_resource* callback = nullptr;
-    wl_resource* tmp      = nullptr;
-    wl_resource_for_each_safe(
-        callback, tmp, &this->current_.frame_callback_list) {
-      wl_callback_send_done(callback, now_msec);
-      wl_resource_destroy(callback);
-    }
-  });
-  server::get().remote->listen_session_frame(this->session_frame_listener_);
-
   LOG_DEBUG("constructor: wl_surface@%u", wl_resource_get_id(this->resource_));
 }
 Surface::~Surface() {
-  wl_list_remove(&this->pending_.frame_callback_list);
-  wl_list_remove(&this->current_.frame_callback_list);
   LOG_DEBUG(" destructor: wl_surface@%u", wl_resource_get_id(this->resource_));
 }
 
-void Surface::enter(input::IntersectInfo& intersect_info) {
-  server::get().seat->client_seats[this->client()]->pointer_foreach(
+void Surface::enter(input::RayId ray, input::IntersectInfo& intersect_info) {
+  auto* client_seat = server::get().seat->client_seats[this->client()];
+  if (!client_seat->acquire_pointer(ray)) {
+    return;
+  }
+  client_seat->pointer_foreach(
       [this, serial = server::get().next_serial(),
           x = wl_fixed_from_double(intersect_info.pos.x),
           y = wl_fixed_from_double(intersect_info.pos.y)](
@@ -116,14 +106,22 @@ void Surface::enter(input::IntersectInfo& intersect_info) {
         wl_pointer_send_enter(wl_pointer, serial, this->resource(), x, y);
       });
 }
-void Surface::leave() {
-  server::get().seat->client_seats[this->client()]->pointer_foreach(
+void Surface::leave(input::RayId ray) {
+  auto* client_seat = server::get().seat->client_seats[this->client()];
+  if (client_seat->pointer_ray() != ray) {
+    return;
+  }
+  client_seat->pointer_foreach(
       [this, serial = server::get().next_serial()](wl_resource* wl_pointer) {
         wl_pointer_send_leave(wl_pointer, serial, this->resource());
       });
 }
-void Surface::motion(input::IntersectInfo& intersect_info) {
-  server::get().seat->client_seats[this->client()]->pointer_foreach(
+void Surface::motion(input::RayId ray, input::IntersectInfo& intersect_info) {
+  auto* client_seat = server::get().seat->client_seats[this->client()];
+  if (client_seat->pointer_ray() != ray) {
+    return;
+  }
+  client_seat->pointer_foreach(
       [serial = server::get().next_serial(),
           x   = wl_fixed_from_double(intersect_info.pos.x),
           y   = wl_fixed_from_double(intersect_info.pos.y)](
@@ -131,8 +129,13 @@ void Surface::motion(input::IntersectInfo& intersect_info) {
         wl_pointer_send_motion(wl_pointer, serial, x, y);
       });
 }
-void Surface::button(uint32_t button, wl_pointer_button_state state) {
-  server::get().seat->client_seats[this->client()]->pointer_foreach(
+void Surface::button(
+    input::RayId ray, uint32_t button, wl_pointer_button_state state) {
+  auto* client_seat = server::get().seat->client_seats[this->client()];
+  if (client_seat->pointer_ray() != ray) {
+    return;
+  }
+  client_seat->pointer_foreach(
       [serial = server::get().next_serial(), now = util::now_msec(), button,
           state](wl_resource* wl_pointer) {
         wl_pointer_send_button(wl_pointer, serial, now, button, state);
@@ -144,16 +147,24 @@ void Surface::button(uint32_t button, wl_pointer_button_state state) {
     }
   }
 }
-void Surface::axis(float amount) {
-  server::get().seat->client_seats[this->client()]->pointer_foreach(
+void Surface::axis(input::RayId ray, float amount) {
+  auto* client_seat = server::get().seat->client_seats[this->client()];
+  if (client_seat->pointer_ray() != ray) {
+    return;
+  }
+  client_seat->pointer_foreach(
       [now = util::now_msec(), amount = wl_fixed_from_double(amount)](
           wl_resource* wl_pointer) {
         wl_pointer_send_axis(
             wl_pointer, now, WL_POINTER_AXIS_VERTICAL_SCROLL, amount);
       });
 }
-void Surface::frame() {
-  server::get().seat->client_seats[this->client()]->pointer_foreach(
+void Surface::frame(input::RayId ray) {
+  auto* client_seat = server::get().seat->client_seats[this->client()];
+  if (client_seat->pointer_ray() != ray) {
+    return;
+  }
+  client_seat->pointer_foreach(
       [](wl_resource* wl_pointer) {
         wl_pointer_send_frame(wl_pointer);
       });
@@ -163,12 +174,9 @@ std::optional<input::IntersectInfo> Surface::check_intersection(
   if (!this->texture_.has_data() || this->role_ == Role::CURSOR) {
     return std::nullopt;
   }
-  auto      geom_mat          = this->geom_.mat();
-  glm::vec3 vert_left_bottom  = geom_mat * glm::vec4(-1.F, -1.F, 0.F, 1.F);
-  glm::vec3 vert_right_bottom = geom_mat * glm::vec4(+1.F, -1.F, 0.F, 1.F);
-  glm::vec3 vert_left_top     = geom_mat * glm::vec4(-1.F, +1.F, 0.F, 1.F);
-  auto      result            = util::intersection::with_surface(
-      origin, direction, vert_left_bottom, vert_right_bottom, vert_left_top);
+  auto result = util::intersection::with_surface(origin, direction,
+      this->corners_.left_bottom, this->corners_.right_bottom,
+      this->corners_.left_top);
   if (!result.has_value()) {
     return std::nullopt;
   }
@@ -181,6 +189,17 @@ std::optional<input::IntersectInfo> Surface::check_intersection(
   };
 }
 
+util::Aabb Surface::world_bounds() {
+  return util::Aabb::from_obb(this->geom_.mat(), glm::vec3(1.F, 1.F, 0.F));
+}
+void Surface::geometry_changed() {
+  auto geom_mat               = this->geom_.mat();
+  this->corners_.left_bottom  = geom_mat * glm::vec4(-1.F, -1.F, 0.F, 1.F);
+  this->corners_.right_bottom = geom_mat * glm::vec4(+1.F, -1.F, 0.F, 1.F);
+  this->corners_.left_top     = geom_mat * glm::vec4(-1.F, +1.F, 0.F, 1.F);
+  this->bounds_changed();
+}
+
 void Surface::init_renderer() {
   this->renderer_ = std::make_unique<Renderer>(kVertShader, kFragShader);
   std::vector<float> vertices{
@@ -203,6 +222,7 @@ void Surface::init_renderer() {
 
   update_pos_and_rot();
   if (this->texture_.has_data()) {
+    remote::UploadScope upload_scope(this->frame_callbacks_);
     this->renderer_->set_texture(
         this->texture_, this->tex_width_, this->tex_height_);
     this->renderer_->commit();
@@ -210,35 +230,42 @@ void Surface::init_renderer() {
 }
 
 void Surface::update_pos_and_rot() {
-  this->geom_.x() = this->distance_ * sin(this->polar_) * sin(this->azimuthal_);
-  this->geom_.y() = kOffsetY + this->distance_ * cos(this->polar_);
-  this->geom_.z() = this->distance_ * sin(this->polar_) * cos(this->azimuthal_);
+  this->geom_.set_pos(glm::vec3(
+      this->distance_ * sin(this->polar_) * sin(this->azimuthal_),
+      kOffsetY + this->distance_ * cos(this->polar_),
+      this->distance_ * sin(this->polar_) * cos(this->azimuthal_)));
 
   // add $pi$ to $azimuthal$ to let Surface look at the camera
-  this->geom_.rot() =
+  this->geom_.set_rot(
       glm::angleAxis(std::numbers::pi_v<float> + this->azimuthal_,
           glm::vec3{0.F, 1.F, 0.F}) *
       glm::angleAxis((std::numbers::pi_v<float> / 2.F) - this->polar_,
-          glm::vec3{1.F, 0.F, 0.F});
+          glm::vec3{1.F, 0.F, 0.F}));
   // updating geom_.size is the responsibility of Surface::set_texture_size()
+  this->geometry_changed();
 
   if (this->renderer_) {
     this->sync_geom();
   }
 }
 void Surface::sync_geom() {
-  auto pos =
-      this->geom_.pos() +
-      (glm::vec3(this->offset_.x, -this->offset_.y, 0.F) / kPixelPerMeter);
-  auto mat = glm::translate(glm::mat4(1.F), pos) * this->geom_.rotation_mat() *
-             (this->is_active_ ? this->geom_.scale_mat() : glm::mat4(0.F));
+  auto mat = glm::mat4(0.F);
+  if (this->is_active_) {
+    // the offset is applied in the world, so translating the cached matrix
+    // is the same as translating `geom_.pos()`
+    auto offset =
+        glm::vec3(this->offset_.x, -this->offset_.y, 0.F) / kPixelPerMeter;
+    mat = glm::translate(glm::mat4(1.F), offset) * this->geom_.mat();
+  }
   this->renderer_->set_uniform_matrix(0, "local_model", mat);
 }
 void Surface::set_texture_size(uint32_t width, uint32_t height) {
   this->tex_width_     = width;
   this->tex_height_    = height;
-  this->geom_.width()  = static_cast<float>(this->tex_width_) / kPixelPerMeter;
-  this->geom_.height() = static_cast<float>(this->tex_height_) / kPixelPerMeter;
+  this->geom_.set_size(
+      static_cast<float>(this->tex_width_) / kPixelPerMeter,
+      static_cast<float>(this->tex_height_) / kPixelPerMeter);
+  this->geometry_changed();
   if (this->renderer_) {
     this->sync_geom();
   }
@@ -261,16 +288,23 @@ void Surface::set_active(bool active) {
 }
 
 void Surface::on_focus() {
-  util::VisitorList([this](
-                        xdg_shell::xdg_toplevel::XdgTopLevel*& xdg_toplevel) {
-    server::get().raise_surface_top(this->resource());
-    xdg_toplevel->set_activated(true);
-  }).visit(this->role_obj_);
+  std::visit(util::Overloaded{
+                 [this](xdg_shell::xdg_toplevel::XdgTopLevel* xdg_toplevel) {
+                   server::get().raise_surface_top(this->resource());
+                   xdg_toplevel->set_activated(true);
+                 },
+                 [](std::nullptr_t) {},
+             },
+      this->role_obj_);
 }
 void Surface::on_unfocus() {
-  util::VisitorList([](xdg_shell::xdg_toplevel::XdgTopLevel*& xdg_toplevel) {
-    xdg_toplevel->set_activated(false);
-  }).visit(this->role_obj_);
+  std::visit(util::Overloaded{
+                 [](xdg_shell::xdg_toplevel::XdgTopLevel* xdg_toplevel) {
+                   xdg_toplevel->set_activated(false);
+                 },
+                 [](std::nullptr_t) {},
+             },
+      this->role_obj_);
 }
 
 void Surface::move(float polar, float azimuthal) {
@@ -283,12 +317,12 @@ void Surface::move(float polar, float azimuthal) {
   }
 }
 void Surface::move(glm::vec3 left_top_pos, glm::quat rot) {
-  this->geom_.pos() = left_top_pos;
-  this->geom_.x() +=
-      static_cast<float>(this->tex_width_) / 2.F / kPixelPerMeter;
-  this->geom_.y() -=
-      static_cast<float>(this->tex_height_) / 2.F / kPixelPerMeter;
-  this->geom_.rot() = rot;
+  auto to_center = glm::vec3(static_cast<float>(this->tex_width_),
+                       -static_cast<float>(this->tex_height_), 0.F) /
+                   2.F / kPixelPerMeter;
+  this->geom_.set_pos(left_top_pos + to_center);
+  this->geom_.set_rot(rot);
+  this->geometry_changed();
 
   if (this->renderer_) {
     this->sync_geom();
@@ -315,9 +349,8 @@ void Surface::attach(wl_resource* buffer) {
     this->pending_.buffer = buffer;
   }
 }
-void Surface::queue_frame_callback(wl_resource* callback_resource) const {
-  wl_list_insert(this->pending_.frame_callback_list.prev,
-      wl_resource_get_link(callback_resource));
+void Surface::queue_frame_callback(wl_resource* callback_resource) {
+  this->frame_callbacks_.queue(callback_resource);
 }
 
 void Surface::listen_committed(util::Listener<std::nullptr_t*>& listener) {
@@ -352,28 +385,33 @@ void Surface::commit() {
   }
 
   if (this->renderer_ != nullptr && this->texture_.has_data()) {
+    remote::UploadScope upload_scope(this->frame_callbacks_);
     this->renderer_->set_texture(
         this->texture_, this->tex_width_, this->tex_height_);
     this->renderer_->commit();
   }
 
-  wl_list_insert_list(
-      &this->current_.frame_callback_list, &this->pending_.frame_callback_list);
-  wl_list_init(&this->pending_.frame_callback_list);
+  this->frame_callbacks_.commit();
 
   this->events_.committed.emit(nullptr);
 }
 
 namespace {
+/// user data of wl_surface is UniPtr<input::BoundedObject> owning Surface
+Surface* get_surface(wl_resource* resource) {
+  auto* obj = static_cast<util::UniPtr<input::BoundedObject>*>(
+      wl_resource_get_user_data(resource));
+  return static_cast<Surface*>(obj->get());
+}
+
 void destroy(wl_client* /*client*/, wl_resource* resource) {
   wl_resource_destroy(resource);
 }
 void attach(wl_client* /*client*/, wl_resource* resource,
     wl_resource* buffer_resource, int32_t dx, int32_t dy) {
-  auto* surface =
-      static_cast<util::UniPtr<Surface>*>(wl_resource_get_user_data(resource));
-  (*surface)->attach(buffer_resource);
-  (*surface)->set_offset({dx, dy});
+  auto* surface = get_surface(resource);
+  surface->attach(buffer_resource);
+  surface->set_offset({dx, dy});
 }
 void damage(wl_client* /*client*/, wl_resource* /*resource*/, int32_t /*x*/,
     int32_t /*y*/, int32_t /*width*/, int32_t /*height*/) {
@@ -391,9 +429,7 @@ void frame(wl_client* client, wl_resource* resource, uint32_t callback) {
         wl_list_remove(wl_resource_get_link(resource));
       });
 
-  auto* self =
-      static_cast<util::UniPtr<Surface>*>(wl_resource_get_user_data(resource));
-  (*self)->queue_frame_callback(callback_resource);
+  get_surface(resource)->queue_frame_callback(callback_resource);
 }
 void set_opaque_region(wl_client* /*client*/, wl_resource* /*resource*/,
     wl_resource* /*region_resource*/) {
@@ -404,9 +440,7 @@ void set_input_region(wl_client* /*client*/, wl_resource* /*resource*/,
   // TODO
 }
 void commit(wl_client* /*client*/, wl_resource* resource) {
-  auto* self =
-      static_cast<util::UniPtr<Surface>*>(wl_resource_get_user_data(resource));
-  (*self)->commit();
+  get_surface(resource)->commit();
 }
 void set_buffer_transform(
     wl_client* /*client*/, wl_resource* /*resource*/, int32_t /*transform*/) {
@@ -422,9 +456,7 @@ void damage_buffer(wl_client* /*client*/, wl_resource* /*resource*/,
 }
 void offset(
     wl_client* /*client*/, wl_resource* resource, int32_t dx, int32_t dy) {
-  auto* surface =
-      static_cast<util::UniPtr<Surface>*>(wl_resource_get_user_data(resource));
-  (*surface)->set_offset({dx, dy});
+  get_surface(resource)->set_offset({dx, dy});
 }
 constexpr struct wl_surface_interface kImpl = {
     .destroy              = destroy,
@@ -441,9 +473,8 @@ constexpr struct wl_surface_interface kImpl = {
 };
 
 void destroy(wl_resource* resource) {
-  auto* surface =
-      static_cast<util::UniPtr<Surface>*>(wl_resource_get_user_data(resource));
-  delete surface;
+  delete static_cast<util::UniPtr<input::BoundedObject>*>(
+      wl_resource_get_user_data(resource));
 }
 }  // namespace
 
@@ -454,9 +485,8 @@ void create(wl_client* client, int version, uint32_t id) {
     wl_client_post_no_memory(client);
     return;
   }
-  auto obj = std::dynamic_pointer_cast<input::BoundedObject>(
-      std::make_shared<Surface>(surface_resource));
-  auto* surface = new util::UniPtr<input::BoundedObject>(std::move(obj));
+  auto* surface = new util::UniPtr<input::BoundedObject>(
+      std::make_unique<Surface>(surface_resource));
   wl_resource_set_implementation(surface_resource, &kImpl, surface, destroy);
   server::get().add_surface(surface->weak());
 }
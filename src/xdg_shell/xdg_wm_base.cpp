@@ -3,6 +3,7 @@
 #include <wayland-server.h>
 #include <xdg-shell-protocol.h>
 
+#include "input/bounded_object.hpp"
 #include "wayland/surface.hpp"
 #include "xdg_shell/xdg_positioner.hpp"
 #include "xdg_shell/xdg_surface.hpp"
@@ -18,10 +19,10 @@ void create_positioner(
 }
 void get_xdg_surface(wl_client* client, wl_resource* resource, uint32_t id,
     wl_resource* surface_resource) {
-  auto* surface = static_cast<util::UniPtr<wayland::surface::Surface>*>(
+  auto* surface = static_cast<util::UniPtr<input::BoundedObject>*>(
       wl_resource_get_user_data(surface_resource));
-  xdg_surface::create(
-      client, wl_resource_get_version(resource), id, (*surface).weak());
+  xdg_surface::create(client, wl_resource_get_version(resource), id,
+      surface->weak_as<wayland::surface::Surface>());
 }
 void pong(
     wl_client* /*client*/, wl_resource* /*resource*/, uint32_t /*serial*/) {
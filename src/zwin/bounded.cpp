@@ -10,14 +10,18 @@
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
+#include <glm/geometric.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <memory>
 #include <optional>
 #include <stdexcept>
 #include <utility>
+#include <vector>
 
 #include "common.hpp"
 #include "input/bounded_object.hpp"
 #include "server.hpp"
+#include "util/aabb.hpp"
 #include "util/convert.hpp"
 #include "util/intersection.hpp"
 #include "util/time.hpp"
@@ -49,7 +53,11 @@ BoundedApp::~BoundedApp() {
   wl_resource_set_destructor(this->resource_, nullptr);
 }
 
-void BoundedApp::enter(input::IntersectInfo& intersect_info) {
+void BoundedApp::enter(input::RayId ray, input::IntersectInfo& intersect_info) {
+  auto* zwn_ray = this->zwn_ray(ray);
+  if (zwn_ray == nullptr) {
+    return;
+  }
   wl_array origin;
   wl_array_init(&origin);
   if (!util::convert::to_wl_array(&intersect_info.origin, &origin)) {
@@ -62,22 +70,23 @@ void BoundedApp::enter(input::IntersectInfo& intersect_info) {
     wl_resource_post_no_memory(this->resource());
     return;
   }
-  server::get().seat->client_seats[this->client()]->ray_foreach(
-      [this, &origin, &direction](wl_resource* zwn_ray) {
-        zwn_ray_send_enter(zwn_ray, server::get().next_serial(),
-            this->virtual_object_->resource(), &origin, &direction);
-      });
+  zwn_ray_send_enter(zwn_ray, server::get().next_serial(),
+      this->virtual_object_->resource(), &origin, &direction);
   wl_array_release(&origin);
   wl_array_release(&direction);
 }
-void BoundedApp::leave() {
-  server::get().seat->client_seats[this->client()]->ray_foreach(
-      [this](wl_resource* zwn_ray) {
-        zwn_ray_send_leave(zwn_ray, server::get().next_serial(),
-            this->virtual_object_->resource());
-      });
+void BoundedApp::leave(input::RayId ray) {
+  if (auto* zwn_ray = this->zwn_ray(ray)) {
+    zwn_ray_send_leave(zwn_ray, server::get().next_serial(),
+        this->virtual_object_->resource());
+  }
 }
-void BoundedApp::motion(input::IntersectInfo& intersect_info) {
+void BoundedApp::motion(
+    input::RayId ray, input::IntersectInfo& intersect_info) {
+  auto* zwn_ray = this->zwn_ray(ray);
+  if (zwn_ray == nullptr) {
+    return;
+  }
   wl_array origin;
   wl_array_init(&origin);
   if (!util::convert::to_wl_array(&intersect_info.origin, &origin)) {
@@ -90,14 +99,16 @@ void BoundedApp::motion(input::IntersectInfo& intersect_info) {
     wl_resource_post_no_memory(this->resource());
     return;
   }
-  server::get().seat->client_seats[this->client()]->ray_foreach(
-      [&origin, &direction](wl_resource* zwn_ray) {
-        zwn_ray_send_motion(zwn_ray, util::now_msec(), &origin, &direction);
-      });
+  zwn_ray_send_motion(zwn_ray, util::now_msec(), &origin, &direction);
   wl_array_release(&origin);
   wl_array_release(&direction);
 }
-void BoundedApp::button(uint32_t button, wl_pointer_button_state wl_state) {
+void BoundedApp::button(
+    input::RayId ray, uint32_t button, wl_pointer_button_state wl_state) {
+  auto* zwn_ray = this->zwn_ray(ray);
+  if (zwn_ray == nullptr) {
+    return;
+  }
   enum zwn_ray_button_state state = ZWN_RAY_BUTTON_STATE_PRESSED;
   switch (wl_state) {
     case WL_POINTER_BUTTON_STATE_PRESSED:
@@ -109,51 +120,44 @@ void BoundedApp::button(uint32_t button, wl_pointer_button_state wl_state) {
     default:
       return;
   }
-  server::get().seat->client_seats[this->client()]->ray_foreach(
-      [button, state](wl_resource* zwn_ray) {
-        zwn_ray_send_button(zwn_ray, server::get().next_serial(),
-            util::now_msec(), button, state);
-      });
+  zwn_ray_send_button(zwn_ray, server::get().next_serial(), util::now_msec(),
+      button, state);
 }
-void BoundedApp::axis(float amount) {
-  server::get().seat->client_seats[this->client()]->ray_foreach(
-      [amount = wl_fixed_from_double(amount)](wl_resource* zwn_ray) {
-        zwn_ray_send_axis(
-            zwn_ray, util::now_msec(), ZWN_RAY_AXIS_VERTICAL_SCROLL, amount);
-      });
+void BoundedApp::axis(input::RayId ray, float amount) {
+  if (auto* zwn_ray = this->zwn_ray(ray)) {
+    zwn_ray_send_axis(zwn_ray, util::now_msec(), ZWN_RAY_AXIS_VERTICAL_SCROLL,
+        wl_fixed_from_double(amount));
+  }
 }
-void BoundedApp::frame() {
-  server::get().seat->client_seats[this->client()]->ray_foreach(
-      [](wl_resource* zwn_ray) {
-        zwn_ray_send_frame(zwn_ray);
-      });
+void BoundedApp::frame(input::RayId ray) {
+  if (auto* zwn_ray = this->zwn_ray(ray)) {
+    zwn_ray_send_frame(zwn_ray);
+  }
+}
+wl_resource* BoundedApp::zwn_ray(input::RayId ray) const {
+  return server::get().seat->client_seats[this->client()]->ray(ray);
 }
 
 std::optional<input::IntersectInfo> BoundedApp::check_intersection(
     const glm::vec3& origin, const glm::vec3& direction) {
-  const auto outer_mat =
-      this->geom_.translation_mat() * this->geom_.rotation_mat();
   auto outer_distance = util::intersection::with_obb(
-      origin, direction, this->current_.half_size, outer_mat);
+      origin, direction, this->current_.half_size, this->geom_.rigid_mat());
   if (!outer_distance.has_value()) {
     return std::nullopt;
   }
 
-  std::optional<float> inner_min_distance;
-  for (auto& region : this->current_.regions) {
-    const auto inner_mat = outer_mat *
-                           glm::translate(glm::mat4(1.F), region.center) *
-                           glm::toMat4(region.quat);
-    auto result = util::intersection::with_obb(
-        origin, direction, region.half_size, inner_mat);
-    if (!result.has_value()) {
-      continue;
-    }
-    if (!inner_min_distance.has_value() ||
-        result.value() < inner_min_distance.value()) {
-      inner_min_distance = result;
-    }
-  }
+  // regions are tested in the space of the outer box, which is rigid,
+  // so distances stay the same
+  const auto&     inv_outer_mat   = this->geom_.inverse_rigid_mat();
+  const glm::vec3 local_origin    = inv_outer_mat * glm::vec4(origin, 1.F);
+  const glm::vec3 local_direction =
+      glm::normalize(inv_outer_mat * glm::vec4(direction, 0.F));
+
+  auto inner_min_distance = this->region_tree_.raycast(local_origin,
+      local_direction, [&](uint32_t first, uint32_t count) {
+        return this->region_batch_.raycast(
+            local_origin, local_direction, first, count);
+      });
   if (!inner_min_distance.has_value()) {
     return std::nullopt;
   }
@@ -165,9 +169,31 @@ std::optional<input::IntersectInfo> BoundedApp::check_intersection(
       .pos       = glm::vec3(),
   };
 }
+util::Aabb BoundedApp::world_bounds() {
+  return util::Aabb::from_obb(
+      this->geom_.rigid_mat(), this->current_.half_size);
+}
+void BoundedApp::build_region_tree() {
+  std::vector<util::Aabb> boxes;
+  std::vector<glm::mat4>  mats;
+  std::vector<glm::vec3>  half_sizes;
+  for (const auto& region : this->current_.regions) {
+    mats.push_back(glm::translate(glm::mat4(1.F), region.center) *
+                   glm::toMat4(region.quat));
+    half_sizes.push_back(region.half_size);
+    boxes.push_back(util::Aabb::from_obb(mats.back(), region.half_size));
+  }
+  this->region_tree_.build(boxes);
+
+  this->region_batch_.clear();
+  for (uint32_t index : this->region_tree_.order()) {
+    this->region_batch_.push(mats[index], half_sizes[index]);
+  }
+}
 
 void BoundedApp::set_region(util::UniPtr<region::Region>* region) {
-  this->pending_.regions = (*region)->regions;
+  this->pending_.regions         = (*region)->regions;
+  this->pending_.regions_changed = true;
 }
 void BoundedApp::configure(wl_array* half_size) {
   glm::vec3 requested_half_size;
@@ -190,21 +216,27 @@ void BoundedApp::ack_configure(uint32_t serial) {
 }
 void BoundedApp::commit() {
   this->current_.half_size = this->pending_.half_size;
-  this->geom_.scale()      = this->pending_.half_size * 2.F;
-  this->current_.regions   = this->pending_.regions;
+  this->geom_.set_scale(this->pending_.half_size * 2.F);
+  // commits caused by move() do not change the regions
+  if (this->pending_.regions_changed) {
+    this->current_.regions         = this->pending_.regions;
+    this->pending_.regions_changed = false;
+    this->build_region_tree();
+  }
+  this->bounds_changed();
 }
 
 void BoundedApp::update_pos_and_rot() {
-  this->geom_.x() =
-      kRadiusFromOrigin * sin(this->polar_) * sin(this->azimuthal_);
-  this->geom_.y() = kOffsetY + kRadiusFromOrigin * cos(this->polar_);
-  this->geom_.z() =
-      kRadiusFromOrigin * sin(this->polar_) * cos(this->azimuthal_);
+  this->geom_.set_pos(glm::vec3(
+      kRadiusFromOrigin * sin(this->polar_) * sin(this->azimuthal_),
+      kOffsetY + kRadiusFromOrigin * cos(this->polar_),
+      kRadiusFromOrigin * sin(this->polar_) * cos(this->azimuthal_)));
 
-  this->geom_.rot() =
+  this->geom_.set_rot(
       glm::angleAxis(this->azimuthal_, glm::vec3{0.F, 1.F, 0.F}) *
       glm::angleAxis(this->polar_ - (std::numbers::pi_v<float> / 2.F),
-          glm::vec3{1.F, 0.F, 0.F});
+          glm::vec3{1.F, 0.F, 0.F}));
+  this->bounds_changed();
 }
 void BoundedApp::move(float polar, float azimuthal) {
   this->polar_ += polar;
@@ -214,14 +246,19 @@ void BoundedApp::move(float polar, float azimuthal) {
 }
 
 namespace {
+/// user data of zwn_bounded is UniPtr<input::BoundedObject> owning BoundedApp
+BoundedApp* get_app(wl_resource* resource) {
+  auto* obj = static_cast<util::UniPtr<input::BoundedObject>*>(
+      wl_resource_get_user_data(resource));
+  return static_cast<BoundedApp*>(obj->get());
+}
+
 void destroy(wl_client* /*client*/, wl_resource* resource) {
   wl_resource_destroy(resource);
 }
 void ack_configure(
     wl_client* /*client*/, wl_resource* resource, uint32_t serial) {
-  auto* self = static_cast<util::UniPtr<BoundedApp>*>(
-      wl_resource_get_user_data(resource));
-  (*self)->ack_configure(serial);
+  get_app(resource)->ack_configure(serial);
 }
 void set_title(
     wl_client* /*client*/, wl_resource* /*resource*/, const char* /*title*/) {
@@ -229,11 +266,9 @@ void set_title(
 }
 void set_region(wl_client* /*client*/, wl_resource* resource,
     wl_resource* region_resource) {
-  auto* self = static_cast<util::UniPtr<BoundedApp>*>(
-      wl_resource_get_user_data(resource));
   auto* region = static_cast<util::UniPtr<region::Region>*>(
       wl_resource_get_user_data(region_resource));
-  (*self)->set_region(region);
+  get_app(resource)->set_region(region);
 }
 void move(wl_client* client, wl_resource* /*resource*/, wl_resource* /*seat*/,
     uint32_t /*serial*/) {
@@ -247,9 +282,8 @@ constexpr struct zwn_bounded_interface kImpl = {
     .move          = move,
 };
 void destroy(wl_resource* resource) {
-  auto* self = static_cast<util::UniPtr<BoundedApp>*>(
+  delete static_cast<util::UniPtr<input::BoundedObject>*>(
       wl_resource_get_user_data(resource));
-  delete self;
 }
 }  // namespace
 
@@ -261,10 +295,9 @@ void create(wl_client* client, uint32_t id, wl_array* half_size,
     wl_client_post_no_memory(client);
     return;
   }
-  auto app = std::make_shared<BoundedApp>(resource, virtual_object);
+  auto app = std::make_unique<BoundedApp>(resource, virtual_object);
   app->configure(half_size);
-  auto  obj  = std::dynamic_pointer_cast<input::BoundedObject>(std::move(app));
-  auto* self = new util::UniPtr<input::BoundedObject>(std::move(obj));
+  auto* self = new util::UniPtr<input::BoundedObject>(std::move(app));
 
   wl_resource_set_implementation(resource, &kImpl, self, destroy);
   server::get().add_bounded_app(self->weak());
@@ -40,9 +40,11 @@ void TextureBindingList::sync(
     auto* sampler = binding.sampler.lock();
     texture->sync(force_sync);
     sampler->sync(force_sync);
-    if (force_sync || this->changed_) {
+    if (force_sync || this->changed_ ||
+        binding.bound_sampler_id != sampler->remote_id()) {
       proxy->BindTexture(binding.binding, binding.name, texture->remote_id(),
           binding.target, sampler->remote_id());
+      binding.bound_sampler_id = sampler->remote_id();
     }
   }
 }
@@ -56,6 +58,21 @@ void TextureBindingList::emplace(uint32_t binding, const char* name,
   this->list_.emplace_back(
       binding, name, target, std::move(texture), std::move(sampler));
   this->changed_ = true;
+  this->listen_damaged();
+}
+const gl_texture::GlTexture* TextureBindingList::primary_texture() const {
+  const TextureBinding* primary = nullptr;
+  for (const auto& binding : this->list_) {
+    if (!primary || binding.binding < primary->binding) {
+      primary = &binding;
+    }
+  }
+  return primary ? primary->texture.lock() : nullptr;
+}
+void TextureBindingList::set_damaged_handler(
+    util::SignalHandler<std::nullptr_t*> handler) {
+  this->damaged_handler_ = std::move(handler);
+  this->listen_damaged();
 }
 
 void TextureBindingList::remove_expired() {
@@ -63,4 +80,23 @@ void TextureBindingList::remove_expired() {
     return !elem.texture.lock() || !elem.sampler.lock();
   });
 }
+void TextureBindingList::listen_damaged() {
+  if (!this->damaged_handler_.has_value()) {
+    return;
+  }
+  this->damaged_listeners_.clear();
+  for (auto& binding : this->list_) {
+    auto* texture = binding.texture.lock();
+    auto* sampler = binding.sampler.lock();
+    if (!texture || !sampler) {
+      continue;
+    }
+    auto& texture_listener = this->damaged_listeners_.emplace_back();
+    texture_listener.set_handler(this->damaged_handler_.value());
+    texture->listen_damaged(texture_listener);
+    auto& sampler_listener = this->damaged_listeners_.emplace_back();
+    sampler_listener.set_handler(this->damaged_handler_.value());
+    sampler->listen_damaged(sampler_listener);
+  }
+}
 }  // namespace yaza::zwin::gles_v32::gl_base_technique
@@ -5,6 +5,7 @@
 #include <zen-remote/server/gl-base-technique.h>
 #include <zwin-gles-v32-protocol.h>
 
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <memory>
@@ -21,9 +22,15 @@ UniformVariable::UniformVariable(
     , row(row)
     , count(count)
     , transpose(transpose)
-    , value(malloc(4UL * col * row), free) {
-  std::memcpy(this->value.get(), value, 4UL * col * row);
+    , value(4UL * col * row * count, util::commit_pool()) {
+  std::memcpy(this->value.data(), value, this->value.size());
 };
+bool UniformVariable::has_same_value(const UniformVariable& other) const {
+  return this->type == other.type && this->location == other.location &&
+         this->name == other.name && this->col == other.col &&
+         this->row == other.row && this->count == other.count &&
+         this->transpose == other.transpose && this->value == other.value;
+}
 
 void UniformVariableList::emplace(
     zwn_gl_base_technique_uniform_variable_type type, uint32_t location,
@@ -43,6 +50,14 @@ void UniformVariableList::commit(
   // to be small enough, right?
   for (auto it = pending.list_.begin(); it != pending.list_.end();) {
     auto& pending_var = *it;
+    // clients tend to set all uniforms every frame; skip unchanged ones
+    if (std::any_of(current.list_.begin(), current.list_.end(),
+            [&pending_var](const UniformVariable& current_var) {
+              return current_var.has_same_value(pending_var);
+            })) {
+      it = pending.list_.erase(it);
+      continue;
+    }
     current.list_.remove_if([&pending_var](UniformVariable& current_var) {
       if (!pending_var.name.empty() && !current_var.name.empty()) {
         return pending_var.name == current_var.name;
@@ -64,7 +79,7 @@ void UniformVariableList::sync(
     if (!force_sync && !uniform_var.newly_comitted) {
       continue;
     }
-    auto* value = uniform_var.value.get();
+    auto* value = static_cast<void*>(uniform_var.value.data());
     if (uniform_var.col == 1) {
       auto f = [&proxy, &uniform_var](auto* value) {
         proxy->GlUniformVector(uniform_var.location, uniform_var.name,
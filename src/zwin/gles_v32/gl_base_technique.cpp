@@ -42,6 +42,15 @@ GlBaseTechnique::GlBaseTechnique(
   });
   this->owner_->listen_commited(this->owner_committed_listener_);
 
+  const auto damage = [this](std::nullptr_t* /*data*/) {
+    this->damage();
+  };
+  this->program_damaged_listener_.set_handler(damage);
+  this->vertex_array_damaged_listener_.set_handler(damage);
+  this->element_array_buffer_damaged_listener_.set_handler(damage);
+  this->pending_.texture_bindings.set_damaged_handler(damage);
+  this->damage();  // the first commit attaches `this` to the owner
+
   LOG_DEBUG("created: GlBaseTechnique");
 }
 GlBaseTechnique::~GlBaseTechnique() {
@@ -52,6 +61,7 @@ GlBaseTechnique::~GlBaseTechnique() {
 }
 
 void GlBaseTechnique::commit() {
+  this->damaged_ = false;
   if (!this->commited_) {
     this->owner_->set_technique(this);
     this->commited_ = true;
@@ -101,8 +111,10 @@ void GlBaseTechnique::sync(bool force_sync) {
 
   if (auto* program = this->current_.program.lock()) {
     program->sync(force_sync);
-    if (should_sync(this->current_.program_changed)) {
+    if (should_sync(this->current_.program_changed) ||
+        this->bound_program_id_ != program->remote_id()) {
       this->proxy_->get()->BindProgram(program->remote_id());
+      this->bound_program_id_ = program->remote_id();
     }
   }
   this->current_.texture_bindings.sync(this->proxy_.value(), force_sync);
@@ -110,23 +122,43 @@ void GlBaseTechnique::sync(bool force_sync) {
   this->current_.draw_api_args.sync(this->proxy_.value(), force_sync);
 }
 
+StateKey GlBaseTechnique::state_key() {
+  StateKey key;
+  if (auto* program = this->current_.program.lock()) {
+    key.program = reinterpret_cast<uintptr_t>(program->identity());
+  }
+  if (auto* vertex_array = this->current_.vertex_array.lock()) {
+    key.vertex_array = reinterpret_cast<uintptr_t>(vertex_array);
+  }
+  key.texture = reinterpret_cast<uintptr_t>(
+      this->current_.texture_bindings.primary_texture());
+  return key;
+}
+
 void GlBaseTechnique::request_bind_program(wl_resource* resource) {
   auto* tmp = static_cast<util::UniPtr<gl_program::GlProgram>*>(
       wl_resource_get_user_data(resource));
   this->pending_.program         = (*tmp).weak();
   this->pending_.program_changed = true;
+  this->program_damaged_listener_.remove();
+  (*tmp)->listen_damaged(this->program_damaged_listener_);
+  this->damage();
 }
 void GlBaseTechnique::request_bind_vertex_array(wl_resource* resource) {
   auto* tmp = static_cast<util::UniPtr<gl_vertex_array::GlVertexArray>*>(
       wl_resource_get_user_data(resource));
   this->pending_.vertex_array         = (*tmp).weak();
   this->pending_.vertex_array_changed = true;
+  this->vertex_array_damaged_listener_.remove();
+  (*tmp)->listen_damaged(this->vertex_array_damaged_listener_);
+  this->damage();
 }
 void GlBaseTechnique::request_bind_texture(uint32_t binding, const char* name,
     uint32_t target, util::WeakPtr<gl_texture::GlTexture>&& texture,
     util::WeakPtr<gl_sampler::GlSampler>&& sampler) {
   this->pending_.texture_bindings.emplace(
       binding, name, target, std::move(texture), std::move(sampler));
+  this->damage();
 }
 void GlBaseTechnique::new_uniform_var(
     zwn_gl_base_technique_uniform_variable_type type, uint32_t location,
@@ -134,10 +166,13 @@ void GlBaseTechnique::new_uniform_var(
     bool transpose, void* value) {
   this->pending_.uniform_vars.emplace(
       type, location, name, col, row, count, transpose, value);
+  this->damage();
 }
 void GlBaseTechnique::request_draw_arrays(
     uint32_t mode, int32_t first, uint32_t count) {
   this->pending_.draw_api_args.set_arrays_args(mode, first, count);
+  this->element_array_buffer_damaged_listener_.remove();
+  this->damage();
 }
 void GlBaseTechnique::request_draw_elements(uint32_t mode, uint32_t count,
     uint32_t type, uint64_t offset, wl_resource* element_array_buffer) {
@@ -145,6 +180,17 @@ void GlBaseTechnique::request_draw_elements(uint32_t mode, uint32_t count,
       wl_resource_get_user_data(element_array_buffer));
   this->pending_.draw_api_args.set_elements_args(
       mode, count, type, offset, (*tmp).weak());
+  this->element_array_buffer_damaged_listener_.remove();
+  (*tmp)->listen_damaged(this->element_array_buffer_damaged_listener_);
+  this->damage();
+}
+
+void GlBaseTechnique::damage() {
+  if (this->damaged_) {
+    return;
+  }
+  this->damaged_ = true;
+  this->owner_->damage();
 }
 
 namespace {
@@ -38,14 +38,21 @@ void GlBuffer::commit() {
   if (!this->pending_.data.has_resource()) {
     return;
   }
-  if (this->current_.data.has_data()) {
-    this->current_.data.reset();
+  util::DataPool data;
+  data.from_weak_resource(this->pending_.data);
+  if (this->current_.data.has_data() &&
+      this->current_.target == this->pending_.target &&
+      this->current_.usage == this->pending_.usage &&
+      this->current_.data.same_content(data)) {
+    // the remote already has the same data
+    server::get().remote->content_store().record_skip(data.size());
+  } else {
+    this->current_.data         = std::move(data);
+    this->current_.data_size    = this->current_.data.size();
+    this->current_.data_damaged = true;
+    this->current_.target       = this->pending_.target;
+    this->current_.usage        = this->pending_.usage;
   }
-  this->current_.data.from_weak_resource(this->pending_.data);
-  this->current_.data_size    = this->current_.data.size();
-  this->current_.data_damaged = true;
-  this->current_.target       = this->pending_.target;
-  this->current_.usage        = this->pending_.usage;
 
   this->pending_.data.zwn_buffer_send_release();
   this->pending_.data.unlink();
@@ -61,6 +68,7 @@ void GlBuffer::sync(bool force_sync) {
   }
   this->proxy_->get()->GlBufferData(this->current_.data.create_buffer(),
       this->current_.target, this->current_.data_size, this->current_.usage);
+  server::get().remote->content_store().record_upload(this->current_.data);
   this->current_.data_damaged = false;
 }
 
@@ -69,6 +77,10 @@ void GlBuffer::update_pending_data(
   this->pending_.target = target;
   this->pending_.usage  = usage;
   this->pending_.data.link(data);
+  this->events_.damaged.emit(nullptr);
+}
+void GlBuffer::listen_damaged(util::Listener<std::nullptr_t*>& listener) {
+  this->events_.damaged.add_listener(listener);
 }
 
 namespace {
@@ -10,8 +10,10 @@
 #include <cstdint>
 #include <memory>
 #include <optional>
+#include <vector>
 
 #include "remote/remote.hpp"
+#include "remote/shader_cache.hpp"
 #include "server.hpp"
 #include "util/weakable_unique_ptr.hpp"
 #include "zwin/gles_v32/gl_shader.hpp"
@@ -51,12 +53,33 @@ void GlProgram::commit() {
 }
 
 void GlProgram::sync(bool force_sync) {
+  auto channel = server::get().remote->channel_nonnull();
+  if (this->current_.should_link) {
+    std::vector<std::shared_ptr<remote::CachedShader>> shaders;
+    for (auto& weak : this->current_.shaders) {
+      if (auto* shader = weak.lock()) {
+        shaders.emplace_back(shader->cached());
+      }
+    }
+    this->cached_ = server::get().remote->shader_cache().get_program(
+        std::move(shaders));
+    this->proxy_               = std::nullopt;
+    this->current_.should_link = false;
+  }
+  if (this->cached_) {
+    // attaching and linking are done only once per session; the proxy of
+    // the entry is dropped on disconnection, so a forced sync recreates it
+    this->cached_->sync(channel);
+    return;
+  }
   if (!this->proxy_.has_value()) {
-    this->proxy_ = zen::remote::server::CreateGlProgram(
-        server::get().remote->channel_nonnull());
+    this->proxy_ = zen::remote::server::CreateGlProgram(channel);
+  }
+  if (!force_sync) {
+    return;
   }
-  bool should_attach = force_sync || this->current_.should_link;
-  // for (auto* shader : this->current_.shaders_) {
+  // the new remote program has the shaders attached so far, but it is not
+  // linked until link is requested
   for (auto it = this->current_.shaders.begin();
       it != this->current_.shaders.end();) {
     auto* shader = it->lock();
@@ -65,25 +88,23 @@ void GlProgram::sync(bool force_sync) {
       continue;
     }
     shader->sync();
-    if (should_attach) {
-      this->proxy_->get()->GlAttachShader(shader->remote_id());
-    }
+    this->proxy_->get()->GlAttachShader(shader->remote_id());
     ++it;
   }
-  if (!should_attach) {
-    return;
-  }
-  this->proxy_->get()->GlLinkProgram();
-  this->current_.should_link = false;
 }
 
 void GlProgram::request_link() {
   this->pending_.damaged     = true;
   this->pending_.should_link = true;
+  this->events_.damaged.emit(nullptr);
 }
 void GlProgram::attach_shader(util::WeakPtr<gl_shader::GlShader>&& shader) {
   this->pending_.damaged = true;
   this->pending_.shaders.emplace_back(std::move(shader));
+  this->events_.damaged.emit(nullptr);
+}
+void GlProgram::listen_damaged(util::Listener<std::nullptr_t*>& listener) {
+  this->events_.damaged.add_listener(listener);
 }
 
 namespace {
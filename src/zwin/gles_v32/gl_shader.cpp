@@ -9,9 +9,9 @@
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
-#include <optional>
 
 #include "remote/remote.hpp"
+#include "remote/shader_cache.hpp"
 #include "server.hpp"
 #include "util/weakable_unique_ptr.hpp"
 #include "zwin/shm/shm_buffer.hpp"
@@ -19,13 +19,13 @@
 namespace yaza::zwin::gles_v32::gl_shader {
 GlShader::GlShader(
     wl_resource* resource, zwin::shm_buffer::ShmBuffer* buffer, uint32_t type)
-    : type_(type), buffer_(buffer), resource_(resource) {
-  this->session_disconnected_listener_.set_handler(
-      [this](std::nullptr_t* /**/) {
-        this->proxy_ = std::nullopt;
-      });
-  server::get().remote->listen_session_disconnected(
-      this->session_disconnected_listener_);
+    : resource_(resource) {
+  // read the source now since the buffer may be destroyed before sync
+  zwin::shm_buffer::begin_access(buffer);
+  this->cached_ = server::get().remote->shader_cache().get_shader(
+      static_cast<char*>(zwin::shm_buffer::get_buffer_data(buffer)),
+      zwin::shm_buffer::get_buffer_size(buffer), type);
+  zwin::shm_buffer::end_access(buffer);
   LOG_DEBUG("created: GlShader");
 }
 GlShader::~GlShader() {
@@ -34,13 +34,7 @@ GlShader::~GlShader() {
   wl_resource_set_destructor(this->resource_, nullptr);
 }
 void GlShader::sync() {
-  if (!this->proxy_.has_value()) {
-    auto*   source = zwin::shm_buffer::get_buffer_data(this->buffer_);
-    ssize_t len    = zwin::shm_buffer::get_buffer_size(this->buffer_);
-    this->proxy_   = zen::remote::server::CreateGlShader(
-        server::get().remote->channel_nonnull(),
-        std::string(static_cast<char*>(source), len), this->type_);
-  }
+  this->cached_->sync(server::get().remote->channel_nonnull());
 }
 
 namespace {
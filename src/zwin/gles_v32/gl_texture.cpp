@@ -17,6 +17,7 @@
 #include "common.hpp"
 #include "remote/remote.hpp"
 #include "server.hpp"
+#include "util/data_pool.hpp"
 #include "util/weakable_unique_ptr.hpp"
 
 namespace yaza::zwin::gles_v32::gl_texture {
@@ -35,12 +36,18 @@ GlTexture::~GlTexture() {
 
 void GlTexture::commit() {
   if (this->pending_.data.has_resource()) {
-    if (this->current_.data.has_data()) {
-      this->current_.data.reset();
+    util::DataPool data;
+    data.from_weak_resource(this->pending_.data);
+    if (this->current_.data.has_data() &&
+        this->current_.image_2d == this->pending_.image_2d &&
+        this->current_.data.same_content(data)) {
+      // the remote already has the same image
+      server::get().remote->content_store().record_skip(data.size());
+    } else {
+      this->current_.image_2d     = this->pending_.image_2d;
+      this->current_.data         = std::move(data);
+      this->current_.data_changed = true;
     }
-    this->current_.image_2d = this->pending_.image_2d;
-    this->current_.data.from_weak_resource(this->pending_.data);
-    this->current_.data_changed = true;
 
     this->pending_.data.zwn_buffer_send_release();
     this->pending_.data.unlink();
@@ -64,6 +71,7 @@ void GlTexture::sync(bool force_sync) {
         this->current_.image_2d.width, this->current_.image_2d.height,
         this->current_.image_2d.border, this->current_.image_2d.format,
         this->current_.image_2d.type, this->current_.data.create_buffer());
+    server::get().remote->content_store().record_upload(this->current_.data);
     this->current_.data_changed = false;
   }
   if (force_sync || this->current_.mipmap_target_changed) {
@@ -75,9 +83,14 @@ void GlTexture::sync(bool force_sync) {
 void GlTexture::new_image_2d(Image2dData& image_2d, wl_resource* data) {
   this->pending_.image_2d = image_2d;
   this->pending_.data.link(data);
+  this->events_.damaged.emit(nullptr);
 }
 void GlTexture::request_generate_mipmap(uint32_t target) {
   this->pending_.mipmap_target = target;
+  this->events_.damaged.emit(nullptr);
+}
+void GlTexture::listen_damaged(util::Listener<std::nullptr_t*>& listener) {
+  this->events_.damaged.add_listener(listener);
 }
 
 namespace {
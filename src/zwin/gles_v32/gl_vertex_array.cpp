@@ -6,6 +6,8 @@
 #include <zen-remote/server/gl-vertex-array.h>
 #include <zwin-gles-v32-protocol.h>
 
+#include <algorithm>
+#include <bit>
 #include <cstdint>
 #include <cstring>
 #include <memory>
@@ -16,22 +18,40 @@
 #include "zwin/gles_v32/gl_buffer.hpp"
 
 namespace yaza::zwin::gles_v32::gl_vertex_array {
-struct VertexAttribute {
-  int32_t                            size;
-  uint32_t                           type;
-  int32_t                            stride;
-  uint64_t                           offset;
-  bool                               normalized;
-  bool                               gl_buffer_changed;
-  util::WeakPtr<gl_buffer::GlBuffer> gl_buffer;
-
-  bool enability_changed;
-  bool enabled;
-  void set_enability(bool enabled) {
-    this->enability_changed = true;
-    this->enabled           = enabled;
+namespace {
+/// move `pending` to `current`; return true if the pointer is changed
+bool commit_attribute(VertexAttribute& pending, VertexAttribute& current) {
+  // changes which are committed but not synced yet must be kept
+  const bool enability_changed =
+      pending.enability_changed || current.enability_changed;
+  const bool pointer_changed =
+      pending.gl_buffer_changed || current.gl_buffer_changed;
+  const bool gl_buffer_changed = pending.gl_buffer_changed;
+
+  current                   = pending;
+  current.enability_changed = enability_changed;
+  current.gl_buffer_changed = pointer_changed;
+  pending.enability_changed = false;
+  pending.gl_buffer_changed = false;
+  return gl_buffer_changed;
+}
+void sync_attribute(zen::remote::server::IGlVertexArray* proxy, uint32_t index,
+    VertexAttribute& attrib, gl_buffer::GlBuffer* buffer, bool force_sync) {
+  if (force_sync || attrib.enability_changed) {
+    if (attrib.enabled) {
+      proxy->GlEnableVertexAttribArray(index);
+    } else {
+      proxy->GlDisableVertexAttribArray(index);
+    }
   }
-};
+  if (force_sync || attrib.gl_buffer_changed) {
+    proxy->GlVertexAttribPointer(index, attrib.size, attrib.type,
+        attrib.normalized, attrib.stride, attrib.offset, buffer->remote_id());
+  }
+  attrib.enability_changed = false;
+  attrib.gl_buffer_changed = false;
+}
+}  // namespace
 
 GlVertexArray::GlVertexArray() {
   this->session_disconnected_listener_.set_handler(
@@ -40,6 +60,14 @@ GlVertexArray::GlVertexArray() {
       });
   server::get().remote->listen_session_disconnected(
       this->session_disconnected_listener_);
+
+  for (uint32_t i = 0; i < kMaxVertexAttribs; ++i) {
+    this->buffer_damaged_listeners_[i].set_handler(
+        [this, i](std::nullptr_t* /*data*/) {
+          this->buffer_damaged_ |= AttributeMask{1} << i;
+          this->events_.damaged.emit(nullptr);
+        });
+  }
   LOG_DEBUG("created: GlVertexArray");
 }
 GlVertexArray::~GlVertexArray() {
@@ -47,17 +75,38 @@ GlVertexArray::~GlVertexArray() {
 }
 
 void GlVertexArray::commit() {
-  this->current_.attribute_map.clear();
-
-  for (auto [index, attrib] : this->pending_.attribute_map) {
-    this->current_.attribute_map.emplace(index, attrib);
-    attrib.enability_changed = false;
-    attrib.gl_buffer_changed = false;
+  bool gl_buffer_changed = false;
+  for (auto dirty = this->pending_.dirty; dirty != 0; dirty &= dirty - 1) {
+    const auto index = std::countr_zero(dirty);
+    gl_buffer_changed |= commit_attribute(
+        this->pending_.attributes[index], this->current_.attributes[index]);
+  }
+  // only the buffers of changed attributes and damaged buffers have
+  // something to commit; committing a buffer twice is a no-op
+  const auto buffer_dirty = this->pending_.dirty | this->buffer_damaged_;
+  this->current_.dirty |= this->pending_.dirty;
+  this->used_ |= this->pending_.dirty;
+  this->pending_.dirty  = 0;
+  this->buffer_damaged_ = 0;
 
+  if (gl_buffer_changed) {
+    this->update_buffers();
+  }
+  for (auto mask = buffer_dirty & this->used_; mask != 0; mask &= mask - 1) {
+    auto& attrib = this->current_.attributes[std::countr_zero(mask)];
     if (auto* buffer = attrib.gl_buffer.lock()) {
       buffer->commit();
     }
   }
+  this->buffer_not_synced_ |= buffer_dirty;
+
+  for (auto& [index, pending] : this->pending_.extra_attributes) {
+    auto& current = this->current_.extra_attributes[index];
+    commit_attribute(pending, current);
+    if (auto* buffer = current.gl_buffer.lock()) {
+      buffer->commit();
+    }
+  }
 }
 
 void GlVertexArray::sync(bool force_sync) {
@@ -65,30 +114,92 @@ void GlVertexArray::sync(bool force_sync) {
     this->proxy_ = zen::remote::server::CreateGlVertexArray(
         server::get().remote->channel_nonnull());
   }
-  for (auto& [index, attrib] : this->current_.attribute_map) {
-    auto* buffer = attrib.gl_buffer.lock();
+  auto* proxy = this->proxy_->get();
+  if (force_sync) {
+    for (auto& weak : this->buffers_) {
+      if (auto* buffer = weak.lock()) {
+        buffer->sync(force_sync);
+      }
+    }
+  } else {
+    auto mask = this->buffer_not_synced_ & this->used_;
+    for (; mask != 0; mask &= mask - 1) {
+      auto& attrib = this->current_.attributes[std::countr_zero(mask)];
+      if (auto* buffer = attrib.gl_buffer.lock()) {
+        buffer->sync(force_sync);
+      }
+    }
+  }
+  this->buffer_not_synced_ = 0;
+
+  AttributeMask not_synced = 0;
+  auto          mask       = force_sync ? this->used_ : this->current_.dirty;
+  for (; mask != 0; mask &= mask - 1) {
+    const auto index  = std::countr_zero(mask);
+    auto&      attrib = this->current_.attributes[index];
+    auto*      buffer = attrib.gl_buffer.lock();
     if (!buffer) {
+      // try again after GlVertexAttribPointer is requested with a live buffer
+      not_synced |= AttributeMask{1} << index;
       continue;
     }
-    buffer->sync(force_sync);
+    sync_attribute(proxy, index, attrib, buffer, force_sync);
+  }
+  this->current_.dirty = not_synced;
 
-    if (force_sync || attrib.enability_changed) {
-      if (attrib.enabled) {
-        this->proxy_->get()->GlEnableVertexAttribArray(index);
-      } else {
-        this->proxy_->get()->GlDisableVertexAttribArray(index);
-      }
-    }
-    if (force_sync || attrib.gl_buffer_changed) {
-      this->proxy_->get()->GlVertexAttribPointer(index, attrib.size,
-          attrib.type, attrib.normalized, attrib.stride, attrib.offset,
-          buffer->remote_id());
+  for (auto& [index, attrib] : this->current_.extra_attributes) {
+    auto* buffer = attrib.gl_buffer.lock();
+    if (!buffer) {
+      continue;
     }
+    buffer->sync(force_sync);
+    sync_attribute(proxy, index, attrib, buffer, force_sync);
   }
 }
 
 VertexAttribute& GlVertexArray::get_pending_attribute(uint32_t index) {
-  return this->pending_.attribute_map[index];
+  if (index >= kMaxVertexAttribs) {
+    this->events_.damaged.emit(nullptr);
+    return this->pending_.extra_attributes[index];
+  }
+  this->pending_.dirty |= AttributeMask{1} << index;
+  this->events_.damaged.emit(nullptr);
+  return this->pending_.attributes[index];
+}
+void GlVertexArray::listen_buffer_damaged(
+    uint32_t index, gl_buffer::GlBuffer* buffer) {
+  if (index >= kMaxVertexAttribs) {
+    auto& listener = this->extra_buffer_damaged_listeners_[index];
+    listener.set_handler([this](std::nullptr_t* /*data*/) {
+      this->events_.damaged.emit(nullptr);
+    });
+    listener.remove();
+    buffer->listen_damaged(listener);
+    return;
+  }
+  auto& listener = this->buffer_damaged_listeners_[index];
+  listener.remove();
+  buffer->listen_damaged(listener);
+}
+
+void GlVertexArray::listen_damaged(util::Listener<std::nullptr_t*>& listener) {
+  this->events_.damaged.add_listener(listener);
+}
+
+void GlVertexArray::update_buffers() {
+  this->buffers_.clear();
+  for (auto used = this->used_; used != 0; used &= used - 1) {
+    auto& weak   = this->current_.attributes[std::countr_zero(used)].gl_buffer;
+    auto* buffer = weak.lock();
+    if (!buffer) {
+      continue;
+    }
+    auto found = std::find_if(this->buffers_.begin(), this->buffers_.end(),
+        [buffer](auto& e) { return e.lock() == buffer; });
+    if (found == this->buffers_.end()) {
+      this->buffers_.emplace_back(weak);
+    }
+  }
 }
 
 namespace {
@@ -129,6 +240,7 @@ void vertex_attrib_pointer(wl_client* /*client*/, wl_resource* resource,
   attrib.stride            = stride;
   attrib.gl_buffer_changed = true;
   attrib.gl_buffer         = buffer->weak();
+  self->get()->listen_buffer_damaged(index, buffer->get());
 }
 constexpr struct zwn_gl_vertex_array_interface kImpl = {
     .destroy                     = destroy,
@@ -27,10 +27,7 @@ RenderingUnit::RenderingUnit(
   server::get().remote->listen_session_disconnected(
       this->session_disconnected_listener_);
 
-  this->owner_committed_listener_.set_handler([this](std::nullptr_t* /*data*/) {
-    this->commit();
-  });
-  this->owner_->listen_commited(this->owner_committed_listener_);
+  this->damage();  // the first commit attaches `this` to the owner
 
   LOG_DEBUG("created: RenderingUnit");
 }
@@ -49,6 +46,7 @@ void RenderingUnit::commit() {
     this->owner_->add_rendering_unit(this);
     this->committed_ = true;
   }
+  this->damaged_ = false;
   this->events_.committed.emit(nullptr);
 }
 
@@ -74,9 +72,23 @@ void RenderingUnit::set_technique(
   this->technique_ = technique;
 }
 
+gl_base_technique::StateKey RenderingUnit::state_key() {
+  if (!this->technique_.has_value()) {
+    return {};
+  }
+  return this->technique_.value()->state_key();
+}
+
 void RenderingUnit::listen_commited(util::Listener<std::nullptr_t*>& listener) {
   this->events_.committed.add_listener(listener);
 }
+void RenderingUnit::damage() {
+  if (this->damaged_) {
+    return;
+  }
+  this->damaged_ = true;
+  this->owner_->damage_rendering_unit(this);
+}
 
 namespace {
 void destroy(wl_client* /*client*/, wl_resource* resource) {
@@ -7,8 +7,10 @@
 #include <cassert>
 #include <csignal>
 #include <cstdint>
+#include <new>
 
 #include "common.hpp"
+#include "util/commit_pool.hpp"
 #include "zwin/shm/shm_pool.hpp"
 
 namespace yaza::zwin::shm_buffer {
@@ -20,6 +22,21 @@ struct ShmBuffer {
 };
 
 namespace {
+/// buffers are attached and released every frame, so take them from the pool
+ShmBuffer* alloc_buffer() {
+  try {
+    void* mem =
+        util::commit_pool()->allocate(sizeof(ShmBuffer), alignof(ShmBuffer));
+    return new (mem) ShmBuffer{};
+  } catch (const std::bad_alloc&) {
+    return nullptr;
+  }
+}
+void free_buffer(ShmBuffer* buffer) {
+  util::commit_pool()->deallocate(
+      buffer, sizeof(ShmBuffer), alignof(ShmBuffer));
+}
+
 void destroy(wl_client* /*client*/, wl_resource* resource) {
   wl_resource_destroy(resource);
 }
@@ -30,13 +47,13 @@ constexpr struct zwn_buffer_interface kImpl = {
 void destroy_buffer(wl_resource* resource) {
   auto* buffer = static_cast<ShmBuffer*>(wl_resource_get_user_data(resource));
   shm_pool::unref(buffer->pool, false);
-  free(buffer);
+  free_buffer(buffer);
 }
 }  // namespace
 
 ShmBuffer* new_buffer(wl_client* client, uint32_t id, shm_pool::ShmPool* pool,
     off_t size, off_t offset) {
-  auto* buffer = zalloc<shm_buffer::ShmBuffer*>(sizeof(shm_buffer::ShmBuffer));
+  auto* buffer = alloc_buffer();
   if (buffer == nullptr) {
     wl_client_post_no_memory(client);
     return nullptr;
@@ -48,7 +65,7 @@ ShmBuffer* new_buffer(wl_client* client, uint32_t id, shm_pool::ShmPool* pool,
   buffer->resource = wl_resource_create(client, &zwn_buffer_interface, 1, id);
   if (buffer->resource == nullptr) {
     wl_client_post_no_memory(client);
-    free(buffer);
+    free_buffer(buffer);
     return nullptr;
   }
   wl_resource_set_implementation(
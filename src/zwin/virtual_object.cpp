@@ -7,8 +7,14 @@
 #include <zen-remote/server/virtual-object.h>
 #include <zwin-protocol.h>
 
+#include <algorithm>
 #include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <ctime>
+#include <iterator>
+#include <list>
+#include <vector>
 #include <glm/gtc/quaternion.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/vec3.hpp>
@@ -16,10 +22,30 @@
 #include "common.hpp"
 #include "remote/session.hpp"
 #include "server.hpp"
-#include "util/time.hpp"
+#include "util/commit_pool.hpp"
 
 namespace yaza::zwin::virtual_object {
-VirtualObject::VirtualObject(wl_resource* resource) : resource_(resource) {
+namespace {
+/// Set YAZA_SORT_RENDERING_UNITS=1 to create rendering units on the remote
+/// grouped by program, vertex array and texture. It is disabled by default
+/// because the protocol does not tell which units rely on the submission
+/// order for blending; the sort is stable so equal states keep their order
+bool should_sort_rendering_units() {
+  static const bool kEnabled = [] {
+    const char* env = std::getenv("YAZA_SORT_RENDERING_UNITS");
+    return env != nullptr && std::strcmp(env, "1") == 0;
+  }();
+  return kEnabled;
+}
+bool by_state(gles_v32::rendering_unit::RenderingUnit* a,
+    gles_v32::rendering_unit::RenderingUnit*           b) {
+  return a->state_key() < b->state_key();
+}
+}  // namespace
+
+VirtualObject::VirtualObject(wl_resource* resource)
+    : frame_callbacks_(server::get().remote->frame_callbacks())
+    , resource_(resource) {
   this->session_established_listener_.set_handler(
       [this](remote::Session* /*data*/) {
         if (this->committed_) {
@@ -33,30 +59,20 @@ VirtualObject::VirtualObject(wl_resource* resource) : resource_(resource) {
   this->session_disconnected_listener_.set_handler(
       [this](std::nullptr_t* /*data*/) {
         this->proxy_ = std::nullopt;
+        // FrameStats has been reset by the disconnection
+        this->state_changes_ = 0;
       });
   server::get().remote->listen_session_disconnected(
       this->session_disconnected_listener_);
 
-  this->session_frame_listener_.set_handler([this](std::nullptr_t* /*data*/) {
-    auto         now_msec = util::now_msec();
-    wl_resource* callback = nullptr;
-    wl_resource* tmp      = nullptr;
-    wl_resource_for_each_safe(
-        callback, tmp, &this->current_.frame_callback_list) {
-      wl_callback_send_done(callback, now_msec);
-      wl_resource_destroy(callback);
-    }
-  });
-  server::get().remote->listen_session_frame(this->session_frame_listener_);
-
-  wl_list_init(&this->pending_.frame_callback_list);
-  wl_list_init(&this->current_.frame_callback_list);
   LOG_DEBUG("created: VirtualObject");
 }
 VirtualObject::~VirtualObject() {
   LOG_DEBUG("destructor: VirtualObject");
-  wl_list_remove(&this->pending_.frame_callback_list);
-  wl_list_remove(&this->current_.frame_callback_list);
+  if (this->proxy_.has_value()) {
+    server::get().remote->frame_stats().update_state_changes(
+        this->state_changes_, 0);
+  }
   this->destroying_ = true;  // disable removing RenderingUnit from list
   for (auto* unit : this->rendering_unit_list_) {
     delete unit;
@@ -67,15 +83,25 @@ VirtualObject::~VirtualObject() {
 }
 
 void VirtualObject::commit() {
-  wl_list_insert_list(
-      &this->current_.frame_callback_list, &this->pending_.frame_callback_list);
-  wl_list_init(&this->pending_.frame_callback_list);
+  this->frame_callbacks_.commit();
+  this->current_.damaged_units.swap(this->pending_.damaged_units);
+  this->pending_.damaged_units.clear();
+  const size_t known_units = this->rendering_unit_list_.size();
+  for (auto* unit : this->current_.damaged_units) {
+    unit->commit();
+  }
+  if (should_sort_rendering_units()) {
+    this->sort_new_rendering_units(known_units);
+  }
   this->committed_ = true;
   this->events_.committed.emit(nullptr);
   if (server::get().remote->has_session()) {
     // sync only updated (damaged) data
     this->sync(false);
   }
+  // if there is no session, everything will be synced
+  // when the session is established
+  this->current_.damaged_units.clear();
 }
 
 // FIXME: give `channel` to all child `sync()` API
@@ -86,17 +112,57 @@ void VirtualObject::sync(bool force_sync) {
     LOG_WARN("VirtualObject is syncing but app is not attached");
     return;
   }
+  // textures and buffers synced below are uploads of this object
+  remote::UploadScope upload_scope(this->frame_callbacks_);
   if (!this->proxy_.has_value()) {
     this->proxy_ = zen::remote::server::CreateVirtualObject(
         server::get().remote->channel_nonnull());
   }
-  auto geom = (*this->app_)->get()->geometry();
-  this->proxy_->get()->Move(
-      glm::value_ptr(geom.pos()), glm::value_ptr(geom.rot()));
-  for (auto* unit : this->rendering_unit_list_) {
-    unit->sync(force_sync);
+  const auto& geom = (*this->app_)->get()->geometry();
+  glm::vec3   pos  = geom.pos();
+  glm::quat   rot  = geom.rot();
+  this->proxy_->get()->Move(glm::value_ptr(pos), glm::value_ptr(rot));
+  if (force_sync) {
+    // every unit is going to be created on the remote
+    if (should_sort_rendering_units()) {
+      this->rendering_unit_list_.sort(by_state);
+    }
+    for (auto* unit : this->rendering_unit_list_) {
+      unit->sync(true);
+    }
+  } else {
+    for (auto* unit : this->current_.damaged_units) {
+      unit->sync(false);
+    }
   }
   this->proxy_->get()->Commit();
+  this->count_state_changes();
+}
+
+void VirtualObject::sort_new_rendering_units(size_t known_units) {
+  // units committed for the first time are created on the remote
+  // in the order of `damaged_units`, so sort both in the same way
+  std::list<gles_v32::rendering_unit::RenderingUnit*> added;
+  added.splice(added.end(), this->rendering_unit_list_,
+      std::next(this->rendering_unit_list_.begin(),
+          static_cast<ptrdiff_t>(known_units)),
+      this->rendering_unit_list_.end());
+  added.sort(by_state);
+  this->rendering_unit_list_.splice(this->rendering_unit_list_.end(), added);
+  std::stable_sort(this->current_.damaged_units.begin(),
+      this->current_.damaged_units.end(), by_state);
+}
+void VirtualObject::count_state_changes() {
+  uint32_t                              count = 0;
+  gles_v32::gl_base_technique::StateKey prev;  // nothing is bound
+  for (auto* unit : this->rendering_unit_list_) {
+    auto key = unit->state_key();
+    count += prev.count_changes(key);
+    prev = key;
+  }
+  server::get().remote->frame_stats().update_state_changes(
+      this->state_changes_, count);
+  this->state_changes_ = count;
 }
 
 void VirtualObject::set_app(
@@ -113,11 +179,16 @@ void VirtualObject::remove_rendering_unit(
   // (when RenderingUnit is deleted by `this`)
   if (!this->destroying_) {
     this->rendering_unit_list_.remove(unit);
+    std::erase(this->pending_.damaged_units, unit);
+    std::erase(this->current_.damaged_units, unit);
   }
 }
-void VirtualObject::queue_frame_callback(wl_resource* callback_resource) const {
-  wl_list_insert(this->pending_.frame_callback_list.prev,
-      wl_resource_get_link(callback_resource));
+void VirtualObject::damage_rendering_unit(
+    gles_v32::rendering_unit::RenderingUnit* unit) {
+  this->pending_.damaged_units.emplace_back(unit);
+}
+void VirtualObject::queue_frame_callback(wl_resource* callback_resource) {
+  this->frame_callbacks_.queue(callback_resource);
 }
 
 void VirtualObject::listen_commited(util::Listener<std::nullptr_t*>& listener) {
@@ -130,6 +201,7 @@ void destroy(wl_client* /*client*/, wl_resource* resource) {
 }
 void commit(wl_client* /*client*/, wl_resource* resource) {
   auto* self = static_cast<VirtualObject*>(wl_resource_get_user_data(resource));
+  util::CommitPoolScope pool_scope;
   self->commit();
 }
 void frame(wl_client* client, wl_resource* resource, uint32_t callback) {
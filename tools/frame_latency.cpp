@@ -0,0 +1,152 @@
+// Wayland client measuring how frame callbacks of yaza are paced.
+// It commits a wl_surface on every frame callback after rendering for a
+// fixed time, like a client driven by `done`, and prints the statistics.
+// usage: frame-latency [seconds (10)] [render_msec (4)]
+
+#include <wayland-client.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <vector>
+
+namespace {
+int64_t now_usec() {
+  std::timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (static_cast<int64_t>(ts.tv_sec) * 1'000'000) + (ts.tv_nsec / 1'000);
+}
+
+struct State {
+  wl_compositor* compositor = nullptr;
+  wl_surface*    surface    = nullptr;
+  int64_t        render_usec = 0;
+  int64_t        end_usec    = 0;
+  bool           running     = true;
+
+  int64_t              done_usec   = -1;
+  int64_t              commit_usec = -1;
+  std::vector<int64_t> intervals;   // done to the next done
+  std::vector<int64_t> waits;       // commit to the next done
+  std::vector<int64_t> deliveries;  // sent by yaza to received, in msec
+};
+
+void commit_frame(State* state);
+
+void frame_done(void* data, wl_callback* callback, uint32_t time_msec) {
+  auto* state = static_cast<State*>(data);
+  wl_callback_destroy(callback);
+  const auto now = now_usec();
+  if (state->done_usec >= 0) {
+    state->intervals.push_back(now - state->done_usec);
+  }
+  if (state->commit_usec >= 0) {
+    state->waits.push_back(now - state->commit_usec);
+  }
+  // yaza sends CLOCK_MONOTONIC in msec truncated to 32 bits
+  state->deliveries.push_back(static_cast<int32_t>(
+      static_cast<uint32_t>(now / 1'000) - time_msec));
+  state->done_usec = now;
+  if (now >= state->end_usec) {
+    state->running = false;
+    return;
+  }
+
+  // the time a client spends to draw the next frame
+  std::timespec render = {
+      .tv_sec  = state->render_usec / 1'000'000,
+      .tv_nsec = (state->render_usec % 1'000'000) * 1'000,
+  };
+  clock_nanosleep(CLOCK_MONOTONIC, 0, &render, nullptr);
+  commit_frame(state);
+}
+constexpr wl_callback_listener kFrameListener = {
+    .done = frame_done,
+};
+
+void commit_frame(State* state) {
+  auto* callback = wl_surface_frame(state->surface);
+  wl_callback_add_listener(callback, &kFrameListener, state);
+  wl_surface_commit(state->surface);
+  state->commit_usec = now_usec();
+}
+
+void registry_global(void* data, wl_registry* registry, uint32_t name,
+    const char* interface, uint32_t /*version*/) {
+  auto* state = static_cast<State*>(data);
+  if (std::strcmp(interface, wl_compositor_interface.name) == 0) {
+    state->compositor = static_cast<wl_compositor*>(
+        wl_registry_bind(registry, name, &wl_compositor_interface, 1));
+  }
+}
+void registry_global_remove(
+    void* /*data*/, wl_registry* /*registry*/, uint32_t /*name*/) {
+}
+constexpr wl_registry_listener kRegistryListener = {
+    .global        = registry_global,
+    .global_remove = registry_global_remove,
+};
+
+void print_stats(const char* name, std::vector<int64_t>& samples,
+    double scale, const char* unit) {
+  if (samples.empty()) {
+    std::printf("%-22s no samples\n", name);
+    return;
+  }
+  std::sort(samples.begin(), samples.end());
+  double sum = 0;
+  for (auto sample : samples) {
+    sum += static_cast<double>(sample);
+  }
+  const auto at = [&samples, scale](double ratio) {
+    auto index = static_cast<size_t>(
+        ratio * static_cast<double>(samples.size() - 1));
+    return static_cast<double>(samples[index]) * scale;
+  };
+  std::printf("%-22s mean %7.2f  p50 %7.2f  p95 %7.2f  max %7.2f %s\n", name,
+      sum / static_cast<double>(samples.size()) * scale, at(0.5), at(0.95),
+      at(1.0), unit);
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  const int64_t seconds     = argc > 1 ? std::atoll(argv[1]) : 10;
+  const int64_t render_msec = argc > 2 ? std::atoll(argv[2]) : 4;
+
+  wl_display* display = wl_display_connect(nullptr);
+  if (!display) {
+    std::fprintf(stderr, "failed to connect to the wayland display\n");
+    return EXIT_FAILURE;
+  }
+  State        state;
+  wl_registry* registry = wl_display_get_registry(display);
+  wl_registry_add_listener(registry, &kRegistryListener, &state);
+  wl_display_roundtrip(display);
+  if (!state.compositor) {
+    std::fprintf(stderr, "wl_compositor is not available\n");
+    return EXIT_FAILURE;
+  }
+
+  state.surface     = wl_compositor_create_surface(state.compositor);
+  state.render_usec = render_msec * 1'000;
+  state.end_usec    = now_usec() + (seconds * 1'000'000);
+  commit_frame(&state);
+  while (state.running && wl_display_dispatch(display) != -1) {
+  }
+
+  const auto frames = state.intervals.size();
+  std::printf("frames: %zu (%.1f fps), render: %ld ms\n", frames,
+      static_cast<double>(frames) / static_cast<double>(seconds), render_msec);
+  print_stats("done to done", state.intervals, 1e-3, "ms");
+  print_stats("commit to done", state.waits, 1e-3, "ms");
+  print_stats("done delivery", state.deliveries, 1.0, "ms");
+
+  wl_surface_destroy(state.surface);
+  wl_compositor_destroy(state.compositor);
+  wl_registry_destroy(registry);
+  wl_display_disconnect(display);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,32 @@
+#!/bin/sh
+# Compare frame latency with YAZA_STAGGER_FRAME_CALLBACKS on and off.
+# yaza is started headless for each mode and `frame-latency` drives a
+# wl_surface from its frame callbacks. No remote session is needed since
+# frame callbacks are paced by the same timer without one.
+# "ms per frame" printed by yaza on exit is the latency from done to the
+# session frame which picks up the commit (render + waiting).
+# usage: tools/frame_latency.sh <yaza> <frame-latency> [seconds] [render_msec]
+set -eu
+
+yaza=$1
+client=$2
+seconds=${3:-10}
+render_msec=${4:-4}
+
+for stagger in 1 0; do
+  dir=$(mktemp -d)
+  XDG_RUNTIME_DIR=$dir YAZA_STAGGER_FRAME_CALLBACKS=$stagger \
+    "$yaza" >"$dir/yaza.log" 2>&1 &
+  pid=$!
+  while [ ! -S "$dir/wayland-0" ]; do
+    sleep 0.1
+  done
+
+  echo "== YAZA_STAGGER_FRAME_CALLBACKS=$stagger"
+  XDG_RUNTIME_DIR=$dir WAYLAND_DISPLAY=wayland-0 \
+    "$client" "$seconds" "$render_msec"
+  kill -TERM "$pid"
+  wait "$pid" || true
+  grep -o "FrameCallbackRegistry: .*" "$dir/yaza.log" || true
+  rm -rf "$dir"
+done
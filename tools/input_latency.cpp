@@ -0,0 +1,257 @@
+// Input client measuring how long yaza takes to handle events.
+// It sends PINGs, optionally after MOUSE_MOVEs whose sum is zero, and
+// measures the time until each PING is sent back, which is after the main
+// thread of yaza has handled every Event sent before it.
+// usage: input-latency <tcp|udp|unix> [host or path] [count (1000)]
+//        [rate_hz (250)] [moves_per_ping (0)]
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include "input/event_decoder.hpp"
+#include "input/input_listen_server.hpp"
+
+namespace {
+using yaza::input::Event;
+using yaza::input::EventType;
+using yaza::input::Transport;
+
+/// sequence number and Events, which fits in the datagram buffer of yaza
+constexpr size_t  kMaxDatagramSize = 2048;
+constexpr int64_t kDrainUsec       = 1'000'000;
+
+int64_t now_usec() {
+  std::timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (static_cast<int64_t>(ts.tv_sec) * 1'000'000) + (ts.tv_nsec / 1'000);
+}
+
+Event make_event(EventType type) {
+  Event event{htonl(yaza::input::kEventMagic), type, {}};
+  return event;
+}
+
+int connect_inet(int type, const char* host) {
+  addrinfo hints{};
+  hints.ai_family   = AF_INET;
+  hints.ai_socktype = type;
+  addrinfo*  result = nullptr;
+  const auto port   = std::to_string(yaza::input::kServerPort);
+  if (int err = getaddrinfo(host, port.c_str(), &hints, &result); err != 0) {
+    std::fprintf(stderr, "failed to resolve %s: %s\n", host, gai_strerror(err));
+    return -1;
+  }
+  int fd = socket(AF_INET, type | SOCK_CLOEXEC, 0);
+  if (fd != -1 && connect(fd, result->ai_addr, result->ai_addrlen) == -1) {
+    close(fd);
+    fd = -1;
+  }
+  freeaddrinfo(result);
+  if (fd != -1 && type == SOCK_STREAM) {
+    int opt = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+  }
+  return fd;
+}
+
+int connect_unix(const std::string& path) {
+  sockaddr_un addr{};
+  addr.sun_family = AF_UNIX;
+  if (path.size() >= sizeof(addr.sun_path)) {
+    std::fprintf(stderr, "socket path is too long: %s\n", path.c_str());
+    return -1;
+  }
+  std::memcpy(addr.sun_path, path.c_str(), path.size());
+  int fd = socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+  if (fd != -1 &&
+      connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) ==
+          -1) {
+    close(fd);
+    fd = -1;
+  }
+  return fd;
+}
+
+std::string default_unix_path() {
+  if (const char* path = std::getenv("YAZA_INPUT_SOCKET")) {
+    return path;
+  }
+  const char* runtime_dir = std::getenv("XDG_RUNTIME_DIR");
+  return std::string(runtime_dir != nullptr ? runtime_dir : "/tmp") +
+         "/yaza-input";
+}
+
+struct State {
+  Transport            transport;
+  int                  fd;
+  std::vector<int64_t> sent_usec;  // indexed by token; -1 once replied
+  std::vector<int64_t> rtts;
+  std::vector<uint8_t> received;  // a stream may split an Event
+};
+
+/// read every PING sent back until `deadline_usec` or all are replied;
+/// return false if the connection is closed
+bool receive_pongs(State& state, int64_t deadline_usec) {
+  while (state.rtts.size() < state.sent_usec.size()) {
+    const auto now = now_usec();
+    if (now >= deadline_usec) {
+      return true;
+    }
+    pollfd fd{.fd = state.fd, .events = POLLIN, .revents = 0};
+    int    timeout_msec = static_cast<int>((deadline_usec - now + 999) / 1000);
+    if (poll(&fd, 1, timeout_msec) <= 0) {
+      continue;
+    }
+    std::array<uint8_t, kMaxDatagramSize> buf;
+    ssize_t size = recv(state.fd, buf.data(), buf.size(), MSG_DONTWAIT);
+    if (size <= 0) {
+      if (size == 0 || (errno != EAGAIN && errno != EINTR)) {
+        std::fprintf(stderr, "connection is closed: %s\n",
+            size == 0 ? "EOF" : std::strerror(errno));
+        return false;
+      }
+      continue;
+    }
+    const auto received_usec = now_usec();
+    if (state.transport == Transport::TCP) {
+      state.received.insert(state.received.end(), buf.begin(),
+          buf.begin() + size);
+    } else {
+      state.received.assign(buf.begin(), buf.begin() + size);
+    }
+
+    size_t offset = 0;
+    for (; offset + sizeof(Event) <= state.received.size();
+         offset += sizeof(Event)) {
+      Event event;
+      std::memcpy(&event, state.received.data() + offset, sizeof(event));
+      if (ntohl(event.magic) != yaza::input::kEventMagic ||
+          event.type != EventType::PING ||
+          event.data.token >= state.sent_usec.size() ||
+          state.sent_usec[event.data.token] < 0) {
+        continue;
+      }
+      state.rtts.push_back(received_usec - state.sent_usec[event.data.token]);
+      state.sent_usec[event.data.token] = -1;
+    }
+    state.received.erase(state.received.begin(),
+        state.received.begin() + static_cast<std::ptrdiff_t>(offset));
+  }
+  return true;
+}
+
+void print_stats(std::vector<int64_t>& samples) {
+  if (samples.empty()) {
+    std::printf("rtt: no samples\n");
+    return;
+  }
+  std::sort(samples.begin(), samples.end());
+  double sum = 0;
+  for (auto sample : samples) {
+    sum += static_cast<double>(sample);
+  }
+  const auto at = [&samples](double ratio) {
+    return samples[static_cast<size_t>(
+        ratio * static_cast<double>(samples.size() - 1))];
+  };
+  std::printf("rtt: mean %.1f  p50 %ld  p95 %ld  p99 %ld  max %ld us\n",
+      sum / static_cast<double>(samples.size()), at(0.5), at(0.95), at(0.99),
+      at(1.0));
+}
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::fprintf(stderr,
+        "usage: %s <tcp|udp|unix> [host or path] [count (1000)] "
+        "[rate_hz (250)] [moves_per_ping (0)]\n",
+        argv[0]);
+    return EXIT_FAILURE;
+  }
+  const std::string transport = argv[1];
+  const uint32_t    count     = argc > 3 ? std::atoi(argv[3]) : 1000;
+  const int64_t     rate_hz   = argc > 4 ? std::atoll(argv[4]) : 250;
+  // MOUSE_MOVEs are sent in pairs so that the pointer stays still
+  size_t moves = argc > 5 ? std::atoi(argv[5]) / 2 * 2 : 0;
+
+  State state{};
+  if (transport == "tcp" || transport == "udp") {
+    const char* host = argc > 2 ? argv[2] : "127.0.0.1";
+    state.transport  = transport == "tcp" ? Transport::TCP : Transport::UDP;
+    state.fd =
+        connect_inet(transport == "tcp" ? SOCK_STREAM : SOCK_DGRAM, host);
+  } else if (transport == "unix") {
+    state.transport = Transport::UNIX;
+    state.fd        = connect_unix(argc > 2 ? argv[2] : default_unix_path());
+  } else {
+    std::fprintf(stderr, "unknown transport: %s\n", transport.c_str());
+    return EXIT_FAILURE;
+  }
+  if (state.fd == -1) {
+    std::fprintf(stderr, "failed to connect: %s\n", std::strerror(errno));
+    return EXIT_FAILURE;
+  }
+  if (state.transport == Transport::UDP) {
+    // a datagram of yaza holds a sequence number, the moves and a PING
+    moves = std::min(moves,
+        ((kMaxDatagramSize - sizeof(uint32_t)) / sizeof(Event) - 1) / 2 * 2);
+  }
+
+  const int64_t interval_usec = 1'000'000 / std::max<int64_t>(rate_hz, 1);
+
+  std::vector<uint8_t> message;
+  int64_t              next_usec = now_usec();
+  for (uint32_t token = 0; token < count; ++token) {
+    message.clear();
+    if (state.transport == Transport::UDP) {
+      const auto* p = reinterpret_cast<const uint8_t*>(&token);
+      message.insert(message.end(), p, p + sizeof(token));
+    }
+    for (size_t i = 0; i < moves; ++i) {
+      auto move             = make_event(EventType::MOUSE_MOVE);
+      move.data.movement[0] = i % 2 == 0 ? 1.F : -1.F;
+      const auto* p         = reinterpret_cast<const uint8_t*>(&move);
+      message.insert(message.end(), p, p + sizeof(move));
+    }
+    auto ping       = make_event(EventType::PING);
+    ping.data.token = token;
+    const auto* p   = reinterpret_cast<const uint8_t*>(&ping);
+    message.insert(message.end(), p, p + sizeof(ping));
+
+    state.sent_usec.push_back(now_usec());
+    if (send(state.fd, message.data(), message.size(), MSG_NOSIGNAL) == -1) {
+      std::fprintf(stderr, "failed to send: %s\n", std::strerror(errno));
+      state.sent_usec.pop_back();
+      break;
+    }
+    next_usec += interval_usec;
+    if (!receive_pongs(state, next_usec)) {
+      break;
+    }
+  }
+  receive_pongs(state, now_usec() + kDrainUsec);
+
+  const auto sent = state.sent_usec.size();
+  std::printf("transport: %s, sent: %zu, lost: %zu, moves per ping: %zu\n",
+      transport.c_str(), sent, sent - state.rtts.size(), moves);
+  print_stats(state.rtts);
+  close(state.fd);
+  return EXIT_SUCCESS;
+}